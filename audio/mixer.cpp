@@ -29,9 +29,72 @@
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 namespace Audio {
 
+#pragma mark -
+#pragma mark --- Accumulator helpers ---
+#pragma mark -
+
+/**
+ * Adds count 16-bit samples to a 32-bit accumulator buffer.
+ */
+static void accumulateSamples(int32 *acc, const int16 *src, uint count) {
+	uint i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= count; i += 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		// Sign extend by moving each sample into the upper half of a
+		// 32-bit lane and shifting it back down.
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+		__m128i *a = (__m128i *)(acc + i);
+		_mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), lo));
+		_mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), hi));
+	}
+#elif defined(__ARM_NEON__)
+	for (; i + 8 <= count; i += 8) {
+		const int16x8_t s = vld1q_s16(src + i);
+		vst1q_s32(acc + i, vaddw_s16(vld1q_s32(acc + i), vget_low_s16(s)));
+		vst1q_s32(acc + i + 4, vaddw_s16(vld1q_s32(acc + i + 4), vget_high_s16(s)));
+	}
+#endif
+
+	for (; i < count; i++)
+		acc[i] += src[i];
+}
+
+/**
+ * Clamps count accumulated samples to the 16-bit range and stores them.
+ */
+static void clampSamples(int16 *dst, const int32 *acc, uint count) {
+	uint i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= count; i += 8) {
+		const __m128i lo = _mm_loadu_si128((const __m128i *)(acc + i));
+		const __m128i hi = _mm_loadu_si128((const __m128i *)(acc + i + 4));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(lo, hi));
+	}
+#elif defined(__ARM_NEON__)
+	for (; i + 8 <= count; i += 8) {
+		const int16x4_t lo = vqmovn_s32(vld1q_s32(acc + i));
+		const int16x4_t hi = vqmovn_s32(vld1q_s32(acc + i + 4));
+		vst1q_s16(dst + i, vcombine_s16(lo, hi));
+	}
+#endif
+
+	for (; i < count; i++)
+		dst[i] = (int16)CLIP<int32>(acc[i], -32768, 32767);
+}
+
 #pragma mark -
 #pragma mark --- Channel classes ---
 #pragma mark -
@@ -42,7 +105,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResampleQuality quality);
 	~Channel();
 
 	/**
@@ -120,6 +183,19 @@ public:
 	 */
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
+	/**
+	 * Queries the effective left and right volume, as computed from
+	 * the channel's volume and balance and the sound type settings.
+	 */
+	void getVolumes(st_volume_t &volL, st_volume_t &volR) const { volL = _volL; volR = _volR; }
+
+	/**
+	 * Sets the left and right volume the channel is mixed with.
+	 * The mixer takes care of passing on the values from getVolumes(),
+	 * possibly from another thread.
+	 */
+	void setMixVolumes(st_volume_t volL, st_volume_t volR) { _mixVolL = volL; _mixVolR = volR; }
+
 	/**
 	 * Queries how long the channel has been playing.
 	 */
@@ -154,6 +230,7 @@ private:
 
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
+	st_volume_t _mixVolL, _mixVolR;
 
 	Mixer *_mixer;
 
@@ -163,6 +240,16 @@ private:
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
+	/**
+	 * Odd while mix() or pause() update the timing values above. In
+	 * lock-free mode these run on the audio thread, so getElapsedTime()
+	 * retries until it read them without an update in between.
+	 */
+	volatile uint32 _timingSeq;
+
+	void beginTimingUpdate() { _timingSeq++; Common::memoryBarrier(); }
+	void endTimingUpdate() { Common::memoryBarrier(); _timingSeq++; }
+
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
 };
@@ -173,23 +260,62 @@ private:
 
 
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _syst(system), _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _syst(system), _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _lockFree(false), _resampleQuality(kResampleLinear), _channelsInFlight(0), _commandsPosted(0), _commandsProcessed(0), _callbackCount(0),
+	  _accumBuffer(0), _channelBuffer(0), _mixBufferSize(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_mixChannels[i] = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	if (_lockFree) {
+		// The audio thread is gone by now, so apply whatever it left in
+		// the queue. Afterwards, _mixChannels matches _channels again.
+		processCommands();
+		reclaimChannels();
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	freeSincTables();
+
+	delete[] _accumBuffer;
+	delete[] _channelBuffer;
 }
 
 void MixerImpl::setReady(bool ready) {
 	_mixerReady = ready;
 }
 
+void MixerImpl::setLockFree(bool lockFree) {
+	Common::StackLock lock(_mutex);
+
+	assert(!_mixerReady);
+	if (_lockFree == lockFree)
+		return;
+
+	if (_lockFree) {
+		processCommands();
+		reclaimChannels();
+	}
+
+	// Let the audio thread start out with the channels already playing
+	_channelsInFlight = 0;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		_mixChannels[i] = lockFree ? _channels[i] : 0;
+		if (_mixChannels[i])
+			_channelsInFlight++;
+	}
+
+	_lockFree = lockFree;
+}
+
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
@@ -208,17 +334,187 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
 	chan->setHandle(chanHandle);
+
+	if (_lockFree) {
+		// Removed channels the audio thread did not hand back yet still
+		// count, so wait for it if there are too many of them
+		if (_channelsInFlight >= MAX_CHANNELS_IN_FLIGHT)
+			syncWithAudioThread();
+		if (_channelsInFlight >= MAX_CHANNELS_IN_FLIGHT) {
+			warning("MixerImpl::insertChannel: too many channels waiting for deletion");
+			delete chan;
+			return;
+		}
+
+		Command cmd;
+		cmd.type = Command::kCmdAdd;
+		cmd.slot = index;
+		cmd.chan = chan;
+		if (!postCommand(cmd)) {
+			warning("MixerImpl::insertChannel: command queue is full");
+			delete chan;
+			return;
+		}
+		_channelsInFlight++;
+	}
+
+	_channels[index] = chan;
+
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
 }
 
+void MixerImpl::removeChannel(int index) {
+	Channel *chan = _channels[index];
+	assert(chan);
+	_channels[index] = 0;
+
+	if (!_lockFree) {
+		delete chan;
+		return;
+	}
+
+	// The audio thread hands the channel back through _retiredChannels
+	// once it stopped mixing it, see reclaimChannels().
+	Command cmd;
+	cmd.type = Command::kCmdRemove;
+	cmd.slot = index;
+	cmd.chan = chan;
+	if (!postCommand(cmd)) {
+		// The audio thread still mixes the channel, so keep it around
+		// rather than losing track of it
+		warning("MixerImpl::removeChannel: command queue is full");
+		_channels[index] = chan;
+	}
+}
+
+void MixerImpl::pauseChannel(int index, bool paused) {
+	if (!_lockFree) {
+		_channels[index]->pause(paused);
+		return;
+	}
+
+	Command cmd;
+	cmd.type = Command::kCmdPause;
+	cmd.slot = index;
+	cmd.chan = _channels[index];
+	cmd.paused = paused;
+	if (!postCommand(cmd))
+		warning("MixerImpl::pauseChannel: command queue is full");
+}
+
+void MixerImpl::updateMixVolumes(int index) {
+	Channel *chan = _channels[index];
+	st_volume_t volL, volR;
+	chan->getVolumes(volL, volR);
+
+	if (!_lockFree) {
+		chan->setMixVolumes(volL, volR);
+		return;
+	}
+
+	Command cmd;
+	cmd.type = Command::kCmdVolume;
+	cmd.slot = index;
+	cmd.chan = chan;
+	cmd.volL = volL;
+	cmd.volR = volR;
+	if (!postCommand(cmd))
+		warning("MixerImpl::updateMixVolumes: command queue is full");
+}
+
+bool MixerImpl::postCommand(const Command &cmd) {
+	// Engine threads serialize on _mutex, so there is only one producer.
+	const uint32 startTime = _syst->getMillis();
+	const uint32 startCount = _callbackCount;
+
+	while (!_commands.push(cmd)) {
+		if (!waitForAudioThread(startTime, startCount))
+			return false;
+	}
+
+	_commandsPosted++;
+	return true;
+}
+
+bool MixerImpl::waitForAudioThread(uint32 startTime, uint32 startCount) {
+	// Don't wait for an audio thread which is not running (anymore),
+	// e.g. because the backend suspended audio output.
+	if (!_mixerReady)
+		return false;
+	if (_callbackCount == startCount && _syst->getMillis() - startTime > 1000)
+		return false;
+
+	_syst->delayMillis(1);
+	return true;
+}
+
+void MixerImpl::syncWithAudioThread() {
+	const uint32 startTime = _syst->getMillis();
+	const uint32 startCount = _callbackCount;
+
+	while ((int32)(_commandsPosted - _commandsProcessed) > 0) {
+		if (!waitForAudioThread(startTime, startCount))
+			break;
+	}
+
+	reclaimChannels();
+}
+
+void MixerImpl::reclaimChannels() {
+	// Called by engine threads with _mutex held, which makes them the
+	// only consumer of _retiredChannels.
+	Channel *chan;
+	while (_retiredChannels.pop(chan)) {
+		const int index = chan->getHandle()._val % NUM_CHANNELS;
+		if (_channels[index] == chan)
+			_channels[index] = 0;
+		delete chan;
+		_channelsInFlight--;
+	}
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		switch (cmd.type) {
+		case Command::kCmdAdd:
+			assert(!_mixChannels[cmd.slot]);
+			_mixChannels[cmd.slot] = cmd.chan;
+			break;
+
+		case Command::kCmdRemove:
+			// The channel might have finished and been retired already
+			if (_mixChannels[cmd.slot] == cmd.chan) {
+				_mixChannels[cmd.slot] = 0;
+				// Cannot fail, since insertChannel() never lets more
+				// channels than the queue holds reach the audio thread
+				const bool retired = _retiredChannels.push(cmd.chan);
+				assert(retired);
+			}
+			break;
+
+		case Command::kCmdPause:
+			if (_mixChannels[cmd.slot] == cmd.chan)
+				cmd.chan->pause(cmd.paused);
+			break;
+
+		case Command::kCmdVolume:
+			if (_mixChannels[cmd.slot] == cmd.chan)
+				cmd.chan->setMixVolumes(cmd.volL, cmd.volR);
+			break;
+		}
+
+		Common::memoryBarrier();
+		_commandsProcessed++;
+	}
+}
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -228,6 +524,7 @@ void MixerImpl::playStream(
 			bool permanent,
 			bool reverseStereo) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	if (stream == 0) {
 		warning("stream is 0");
@@ -258,17 +555,22 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resampleQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
+
+	// Nobody else knows about the channel yet, so this is safe in
+	// lock-free mode, too.
+	st_volume_t volL, volR;
+	chan->getVolumes(volL, volR);
+	chan->setMixVolumes(volL, volR);
+
 	insertChannel(handle, chan);
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -277,6 +579,11 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	if (_lockFree)
+		return mixLockFree(buf, len);
+
+	Common::StackLock lock(_mutex);
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
@@ -298,45 +605,97 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	return res;
 }
 
+int MixerImpl::mixLockFree(int16 *buf, uint len) {
+	processCommands();
+	_callbackCount++;
+
+	const uint count = 2 * len;
+	if (count > _mixBufferSize) {
+		// Only happens on the first callback or if the backend switches
+		// to a larger buffer, so we can live with allocating here.
+		delete[] _accumBuffer;
+		delete[] _channelBuffer;
+		_accumBuffer = new int32[count];
+		_channelBuffer = new int16[count];
+		_mixBufferSize = count;
+	}
+
+	memset(_accumBuffer, 0, count * sizeof(int32));
+
+	// Let every channel produce its samples on its own and sum them up in
+	// the 32-bit accumulator, so that we only need to clip once at the end.
+	int res = 0, tmp;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Channel *chan = _mixChannels[i];
+		if (!chan)
+			continue;
+
+		if (chan->isFinished()) {
+			// Leave deleting the channel (and its stream) to the engine side
+			if (_retiredChannels.push(chan))
+				_mixChannels[i] = 0;
+		} else if (!chan->isPaused()) {
+			memset(_channelBuffer, 0, count * sizeof(int16));
+			tmp = chan->mix(_channelBuffer, len);
+			accumulateSamples(_accumBuffer, _channelBuffer, 2 * tmp);
+
+			if (tmp > res)
+				res = tmp;
+		}
+	}
+
+	clampSamples(buf, _accumBuffer, count);
+	return res;
+}
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && !_channels[i]->isPermanent())
+			removeChannel(i);
 	}
+	if (_lockFree)
+		syncWithAudioThread();
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && _channels[i]->getId() == id)
+			removeChannel(i);
 	}
+	if (_lockFree)
+		syncWithAudioThread();
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	removeChannel(index);
+	if (_lockFree)
+		syncWithAudioThread();
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= type && type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channels[i] && _channels[i]->getType() == type) {
 			_channels[i]->notifyGlobalVolChange();
+			updateMixVolumes(i);
+		}
 	}
 }
 
@@ -347,12 +706,14 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
 	_channels[index]->setVolume(volume);
+	updateMixVolumes(index);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
@@ -365,12 +726,14 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
 	_channels[index]->setBalance(balance);
+	updateMixVolumes(index);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
@@ -387,6 +750,7 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -397,18 +761,20 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
+			pauseChannel(i, paused);
 		}
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+			pauseChannel(i, paused);
 			return;
 		}
 	}
@@ -416,17 +782,19 @@ void MixerImpl::pauseID(int id, bool paused) {
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	// Simply ignore (un)pause requests for sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	_channels[index]->pause(paused);
+	pauseChannel(index, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
@@ -435,6 +803,7 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
 		return _channels[index]->getId();
@@ -443,12 +812,14 @@ int MixerImpl::getSoundID(SoundHandle handle) {
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	const int index = handle._val % NUM_CHANNELS;
 	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
@@ -468,11 +839,14 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// scaling? See also Player_V2::setMasterVolume
 
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 	_soundTypeSettings[type].volume = volume;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channels[i] && _channels[i]->getType() == type) {
 			_channels[i]->notifyGlobalVolChange();
+			updateMixVolumes(i);
+		}
 	}
 }
 
@@ -488,16 +862,17 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResampleQuality quality)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0),
+      _balance(0), _volL(0), _volR(0), _mixVolL(0), _mixVolR(0),
+      _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+      _pauseStartTime(0), _pauseTime(0), _timingSeq(0), _converter(0),
       _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -552,6 +927,8 @@ void Channel::updateChannelVolumes() {
 void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	beginTimingUpdate();
+
 	if (paused) {
 		_pauseLevel++;
 
@@ -565,6 +942,8 @@ void Channel::pause(bool paused) {
 			_pauseStartTime = 0;
 		}
 	}
+
+	endTimingUpdate();
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -573,17 +952,32 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	// Take a consistent snapshot of the values maintained by mix() and
+	// pause(), which may be running on the audio thread right now.
+	uint32 seq, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		seq = _timingSeq;
+		Common::memoryBarrier();
+		samplesConsumed = _samplesConsumed;
+		mixerTimeStamp = _mixerTimeStamp;
+		pauseStartTime = _pauseStartTime;
+		pauseTime = _pauseTime;
+		paused = isPaused();
+		Common::memoryBarrier();
+	} while ((seq & 1) || seq != _timingSeq);
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis() - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis() - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -604,10 +998,12 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
+		beginTimingUpdate();
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis();
 		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		endTimingUpdate();
+		res = _converter->flow(*_stream, data, len, _mixVolL, _mixVolR);
 		_samplesDecoded += res;
 	}
 
@@ -25,7 +25,9 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/lockfree-queue.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -42,6 +44,12 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Backends may switch the mixer into lock-free mode via setLockFree()
+ * before calling setReady(true). In that mode mixCallback() never waits
+ * for a mutex: engine threads hand channel changes to the audio thread
+ * through a command queue instead, and the audio thread hands channels
+ * it is done with back to the engine side, which deletes them.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -51,7 +59,30 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 256,
+		RETIRED_QUEUE_SIZE = COMMAND_QUEUE_SIZE + NUM_CHANNELS,
+		/** At most this many channels can be waiting in _retiredChannels. */
+		MAX_CHANNELS_IN_FLIGHT = RETIRED_QUEUE_SIZE - 1
+	};
+
+	/**
+	 * A channel change requested by an engine thread, which the audio
+	 * thread applies at the start of its next callback (lock-free mode).
+	 */
+	struct Command {
+		enum Type {
+			kCmdAdd,		///< Start mixing chan in the given slot
+			kCmdRemove,		///< Stop mixing chan and hand it back for deletion
+			kCmdPause,		///< Pause (paused == true) or unpause chan
+			kCmdVolume		///< Set the left/right volume chan is mixed with
+		};
+
+		Type type;
+		int slot;
+		Channel *chan;
+		bool paused;
+		st_volume_t volL, volR;
 	};
 
 	OSystem *_syst;
@@ -71,6 +102,30 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	bool _lockFree;
+	ResampleQuality _resampleQuality;
+
+	/** The channels being mixed, only ever touched by the audio thread. */
+	Channel *_mixChannels[NUM_CHANNELS];
+
+	Common::LockFreeQueue<Command, COMMAND_QUEUE_SIZE> _commands;
+	Common::LockFreeQueue<Channel *, RETIRED_QUEUE_SIZE> _retiredChannels;
+
+	/**
+	 * The channels handed to the audio thread which were not deleted yet.
+	 * Kept at or below MAX_CHANNELS_IN_FLIGHT, so that the audio thread
+	 * never finds _retiredChannels full.
+	 */
+	uint _channelsInFlight;
+
+	uint32 _commandsPosted;
+	volatile uint32 _commandsProcessed;
+	volatile uint32 _callbackCount;
+
+	int32 *_accumBuffer;
+	int16 *_channelBuffer;
+	uint _mixBufferSize;
+
 
 public:
 
@@ -121,6 +176,17 @@ public:
 
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	void removeChannel(int index);
+	void pauseChannel(int index, bool paused);
+	void updateMixVolumes(int index);
+
+	bool postCommand(const Command &cmd);
+	bool waitForAudioThread(uint32 startTime, uint32 startCount);
+	void syncWithAudioThread();
+	void reclaimChannels();
+
+	void processCommands();
+	int mixLockFree(int16 *buf, uint len);
 
 public:
 	/**
@@ -140,6 +206,27 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Enable or disable the lock-free mixing mode. This must be done
+	 * before the mixer is set ready, i.e. before mixCallback() is
+	 * invoked for the first time.
+	 *
+	 * In lock-free mode, stopAll(), stopID() and stopHandle() must not
+	 * be called from within mixCallback() (e.g. from an AudioStream
+	 * being mixed), since they wait until the audio thread has let go
+	 * of the affected channels.
+	 */
+	void setLockFree(bool lockFree);
+	bool isLockFree() const { return _lockFree; }
+
+	/**
+	 * Set the quality used for converting sounds whose sample rate
+	 * differs from the output rate. This only affects sounds started
+	 * afterwards.
+	 */
+	void setResampleQuality(ResampleQuality quality) { _resampleQuality = quality; }
+	ResampleQuality getResampleQuality() const { return _resampleQuality; }
 };
 
 
@@ -31,10 +31,18 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
 #include "common/frac.h"
+#include "common/memorybarrier.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 namespace Audio {
 
 
@@ -47,6 +55,117 @@ namespace Audio {
 #define INTERMEDIATE_BUFFER_SIZE 512
 
 
+#pragma mark -
+
+
+/**
+ * Scales a block of frames by the channel volumes and adds them to the
+ * (always stereo) output buffer, clipping the result.
+ *
+ * The frames in ibuf are laid out like the converter input, i.e. either
+ * interleaved stereo or mono. The result is identical to applying
+ * clampedAdd() sample by sample, the vector code paths just do it for
+ * several frames at once.
+ */
+template<bool stereo, bool reverseStereo>
+static void mixFrames(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t numFrames, st_volume_t vol_l, st_volume_t vol_r) {
+	st_size_t i = 0;
+
+#if !defined(OUTPUT_UNSIGNED_AUDIO) && (defined(__SSE2__) || defined(__ARM_NEON__))
+	// The vector code divides by shifting, which needs a power of two
+	if (Audio::Mixer::kMaxMixerVolume == 256) {
+#if defined(__SSE2__)
+		// Volumes in the order they apply to the output buffer
+		const __m128i vol = reverseStereo ?
+			_mm_set_epi16(vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r) :
+			_mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+		const __m128i roundMask = _mm_set1_epi32(255);
+
+		for (; i + 4 <= numFrames; i += 4) {
+			__m128i in;
+			if (stereo) {
+				in = _mm_loadu_si128((const __m128i *)(ibuf + 2 * i));
+				if (reverseStereo) {
+					in = _mm_shufflelo_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+					in = _mm_shufflehi_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+				}
+			} else {
+				in = _mm_loadl_epi64((const __m128i *)(ibuf + i));
+				in = _mm_unpacklo_epi16(in, in);
+			}
+
+			// Full 32 bit products of samples and volumes
+			const __m128i prodLo = _mm_mullo_epi16(in, vol);
+			const __m128i prodHi = _mm_mulhi_epi16(in, vol);
+			__m128i p0 = _mm_unpacklo_epi16(prodLo, prodHi);
+			__m128i p1 = _mm_unpackhi_epi16(prodLo, prodHi);
+
+			// Divide by 256, rounding towards zero like the C division
+			p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), roundMask)), 8);
+			p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), roundMask)), 8);
+
+			// Add to the output and saturate
+			__m128i *out = (__m128i *)(obuf + 2 * i);
+			const __m128i o = _mm_loadu_si128(out);
+			p0 = _mm_add_epi32(p0, _mm_srai_epi32(_mm_unpacklo_epi16(o, o), 16));
+			p1 = _mm_add_epi32(p1, _mm_srai_epi32(_mm_unpackhi_epi16(o, o), 16));
+			_mm_storeu_si128(out, _mm_packs_epi32(p0, p1));
+		}
+#else
+		const int16 volOrder[4] = {
+			(int16)(reverseStereo ? vol_r : vol_l), (int16)(reverseStereo ? vol_l : vol_r),
+			(int16)(reverseStereo ? vol_r : vol_l), (int16)(reverseStereo ? vol_l : vol_r)
+		};
+		const int16x4_t vol = vld1_s16(volOrder);
+
+		for (; i + 4 <= numFrames; i += 4) {
+			int16x4_t in0, in1;
+			if (stereo) {
+				int16x8_t in = vld1q_s16(ibuf + 2 * i);
+				if (reverseStereo)
+					in = vrev32q_s16(in);
+				in0 = vget_low_s16(in);
+				in1 = vget_high_s16(in);
+			} else {
+				const int16x4x2_t in = vzip_s16(vld1_s16(ibuf + i), vld1_s16(ibuf + i));
+				in0 = in.val[0];
+				in1 = in.val[1];
+			}
+
+			int32x4_t p0 = vmull_s16(in0, vol);
+			int32x4_t p1 = vmull_s16(in1, vol);
+
+			// Divide by 256, rounding towards zero like the C division
+			p0 = vshrq_n_s32(vaddq_s32(p0, vandq_s32(vshrq_n_s32(p0, 31), vdupq_n_s32(255))), 8);
+			p1 = vshrq_n_s32(vaddq_s32(p1, vandq_s32(vshrq_n_s32(p1, 31), vdupq_n_s32(255))), 8);
+
+			int16 *out = obuf + 2 * i;
+			const int16x8_t o = vld1q_s16(out);
+			p0 = vaddw_s16(p0, vget_low_s16(o));
+			p1 = vaddw_s16(p1, vget_high_s16(o));
+			vst1q_s16(out, vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1)));
+		}
+#endif
+	}
+#endif
+
+	for (; i < numFrames; i++) {
+		st_sample_t out0, out1;
+		out0 = (stereo ? ibuf[2 * i] : ibuf[i]);
+		out1 = (stereo ? ibuf[2 * i + 1] : out0);
+
+		// output left channel
+		clampedAdd(obuf[2 * i + reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[2 * i + (reverseStereo ^ 1)], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	}
+}
+
+
+#pragma mark -
+
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -60,6 +179,9 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** resampled frames waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -109,37 +231,47 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
+		// Pick a block of frames from the input, then mix them all at once
+		const st_size_t blockFrames = MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1));
+		st_sample_t *bufPtr = outBuf;
+		bool endOfInput = false;
+
+		for (st_size_t frame = 0; frame < blockFrames; frame++) {
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
+
+			*bufPtr++ = *inPtr++;
+			if (stereo)
+				*bufPtr++ = *inPtr++;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
-
-		// Increment output position
-		opos += opos_inc;
-
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
+		}
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		const st_size_t numFrames = (bufPtr - outBuf) / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
 
-		obuf += 2;
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -173,6 +305,9 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** interpolated frames waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -218,47 +353,331 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+		// Interpolate a block of frames, then mix them all at once
+		const st_sample_t *bufEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1)) * (stereo ? 2 : 1);
+		st_sample_t *bufPtr = outBuf;
+		bool endOfInput = false;
+
+		while (bufPtr < bufEnd) {
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (endOfInput)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the block.
+			while (opos < (frac_t)FRAC_ONE && bufPtr < bufEnd) {
+				// interpolate
+				*bufPtr++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
+				if (stereo)
+					*bufPtr++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS));
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS)) :
-						  out0);
+		const st_size_t numFrames = (bufPtr - outBuf) / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		if (endOfInput)
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
 
-			obuf += 2;
+#pragma mark -
 
-			// Increment output position
-			opos += opos_inc;
+
+/**
+ * Filter coefficients for converting between one pair of sample rates.
+ *
+ * Row p holds the taps for an output sample which lies p / numPhases
+ * input samples after the center of the filter. The coefficients are
+ * 2.14 fixed point values and each row sums up to 1.0.
+ */
+struct SincFilterTable {
+	st_rate_t inStep;	///< input rate divided by the gcd of both rates
+	st_rate_t outStep;	///< output rate divided by the gcd of both rates
+	ResampleQuality quality;
+
+	int numTaps;
+	int numPhases;
+	int16 *coeffs;
+
+	SincFilterTable *next;
+};
+
+enum {
+	SINC_COEFF_BITS = 14,
+	SINC_MAX_PHASES = 1024
+};
+
+/**
+ * All filter tables built so far. Channels playing at the same rates
+ * share their table, and as there are only ever a handful of distinct
+ * rate pairs in use, tables are kept around until freeSincTables() is
+ * called when the mixer goes away.
+ */
+static SincFilterTable *s_sincTables = 0;
+
+static SincFilterTable *createSincTable(st_rate_t inStep, st_rate_t outStep, ResampleQuality quality) {
+	// Half the number of taps and the bandwidth (relative to the lower
+	// Nyquist frequency) for each quality tier.
+	static const int halfTaps[] = { 0, 8, 16, 32 };
+	static const double rolloff[] = { 0.0, 0.85, 0.90, 0.94 };
+
+	SincFilterTable *table = new SincFilterTable;
+	table->inStep = inStep;
+	table->outStep = outStep;
+	table->quality = quality;
+
+	// When downsampling, the filter has to be correspondingly wider to
+	// keep the same transition band.
+	const double cutoff = MIN<double>(1.0, (double)outStep / inStep) * rolloff[quality];
+	const int widen = CLIP<int>((inStep + outStep - 1) / outStep, 1, 4);
+	const int half = halfTaps[quality] * widen;
+
+	table->numTaps = 2 * half;
+	table->numPhases = MIN<int>(outStep, SINC_MAX_PHASES);
+	table->coeffs = new int16[table->numTaps * table->numPhases];
+
+	double *row = new double[table->numTaps];
+	for (int p = 0; p < table->numPhases; p++) {
+		const double phase = (double)p / table->numPhases;
+
+		double sum = 0.0;
+		for (int k = 0; k < table->numTaps; k++) {
+			// Distance of tap k from the output sample, in input samples
+			const double d = k - half + 1 - phase;
+			const double x = d / half;
+
+			// Blackman-Harris window
+			const double window = 0.35875 + 0.48829 * cos(M_PI * x) + 0.14128 * cos(2 * M_PI * x) + 0.01168 * cos(3 * M_PI * x);
+			const double sinc = (d == 0.0) ? 1.0 : sin(M_PI * cutoff * d) / (M_PI * cutoff * d);
+
+			row[k] = cutoff * sinc * window;
+			sum += row[k];
+		}
+
+		// Normalize for unity gain, so that DC passes unchanged. Rounding
+		// errors are put on the center tap, where they matter least.
+		int16 *out = table->coeffs + p * table->numTaps;
+		int total = 0;
+		for (int k = 0; k < table->numTaps; k++) {
+			out[k] = (int16)floor(row[k] / sum * (1 << SINC_COEFF_BITS) + 0.5);
+			total += out[k];
+		}
+		out[half - 1] += (1 << SINC_COEFF_BITS) - total;
+	}
+	delete[] row;
+
+	return table;
+}
+
+static const SincFilterTable *getSincTable(st_rate_t inrate, st_rate_t outrate, ResampleQuality quality) {
+	const st_rate_t div = Common::gcd(inrate, outrate);
+	const st_rate_t inStep = inrate / div;
+	const st_rate_t outStep = outrate / div;
+
+	for (const SincFilterTable *table = s_sincTables; table; table = table->next) {
+		if (table->inStep == inStep && table->outStep == outStep && table->quality == quality)
+			return table;
+	}
+
+	// Converters may be created from different threads (e.g. by the mixer
+	// and by engines doing their own mixing), but only the list head is
+	// ever modified. If two threads add a table at the same time, one of
+	// them is just not found again later, which costs nothing but memory.
+	SincFilterTable *table = createSincTable(inStep, outStep, quality);
+	table->next = s_sincTables;
+	Common::memoryBarrier();
+	s_sincTables = table;
+	return table;
+}
+
+void freeSincTables() {
+	while (s_sincTables) {
+		SincFilterTable *table = s_sincTables;
+		s_sincTables = table->next;
+		delete[] table->coeffs;
+		delete table;
+	}
+}
+
+/**
+ * Audio rate converter based on band limited interpolation with a
+ * windowed sinc filter.
+ *
+ * The filter is evaluated as a polyphase filter bank, i.e. for each
+ * output sample one precomputed row of coefficients is applied to the
+ * most recent input samples. The output lags half the filter length
+ * behind the input.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
+
+	/** filtered frames waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	const SincFilterTable *_table;
+
+	/**
+	 * The most recent input samples of each channel. Every sample is
+	 * stored twice, numTaps entries apart, so that the filter can always
+	 * read numTaps samples in a row starting at _histPos.
+	 */
+	int16 *_hist[2];
+	int _histPos;
+
+	/** position between the two center taps, in 1/outStep input samples */
+	st_rate_t _phase;
+
+	bool nextInputFrame(AudioStream &input);
+	int16 filter(const int16 *hist, const int16 *coeffs) const;
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate, ResampleQuality quality);
+	~SincRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate, ResampleQuality quality) {
+	assert(quality != kResampleLinear);
+
+	_table = getSincTable(inrate, outrate, quality);
+
+	// Start out with silence in the whole filter
+	for (int i = 0; i < (stereo ? 2 : 1); i++) {
+		_hist[i] = new int16[2 * _table->numTaps];
+		memset(_hist[i], 0, 2 * _table->numTaps * sizeof(int16));
+	}
+	if (!stereo)
+		_hist[1] = 0;
+	_histPos = 0;
+
+	// Pull in the first input frame before producing any output
+	_phase = _table->outStep;
+
+	inLen = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	delete[] _hist[0];
+	delete[] _hist[1];
+}
+
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::nextInputFrame(AudioStream &input) {
+	// Check if we have to refill the buffer
+	if (inLen == 0) {
+		inPtr = inBuf;
+		inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+		if (inLen <= 0) {
+			inLen = 0;
+			return false;
+		}
+	}
+	inLen -= (stereo ? 2 : 1);
+
+	const int numTaps = _table->numTaps;
+	for (int i = 0; i < (stereo ? 2 : 1); i++) {
+		const int16 sample = *inPtr++;
+		_hist[i][_histPos] = sample;
+		_hist[i][_histPos + numTaps] = sample;
+	}
+	if (++_histPos == numTaps)
+		_histPos = 0;
+
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+int16 SincRateConverter<stereo, reverseStereo>::filter(const int16 *hist, const int16 *coeffs) const {
+	int32 sum = 1 << (SINC_COEFF_BITS - 1);
+	for (int k = 0; k < _table->numTaps; k++)
+		sum += hist[k] * coeffs[k];
+
+	// The filter can overshoot at sharp edges
+	return (int16)CLIP<int32>(sum >> SINC_COEFF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	const st_rate_t inStep = _table->inStep;
+	const st_rate_t outStep = _table->outStep;
+
+	while (obuf < oend) {
+		// Filter a block of frames, then mix them all at once
+		const st_size_t blockFrames = MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1));
+		st_sample_t *bufPtr = outBuf;
+		bool endOfInput = false;
+
+		for (st_size_t frame = 0; frame < blockFrames; frame++) {
+			// Advance the input until the output position lies between
+			// the two center taps again
+			while (_phase >= outStep) {
+				if (!nextInputFrame(input)) {
+					endOfInput = true;
+					break;
+				}
+				_phase -= outStep;
+			}
+
+			if (endOfInput)
+				break;
+
+			const int row = (outStep <= SINC_MAX_PHASES) ? _phase : (int)(_phase * SINC_MAX_PHASES / outStep);
+			const int16 *coeffs = _table->coeffs + row * _table->numTaps;
+
+			*bufPtr++ = filter(_hist[0] + _histPos, coeffs);
+			if (stereo)
+				*bufPtr++ = filter(_hist[1] + _histPos, coeffs);
+
+			_phase += inStep;
 		}
+
+		const st_size_t numFrames = (bufPtr - outBuf) / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
+
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -283,7 +702,6 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
 		st_sample_t *ostart = obuf;
@@ -303,22 +721,14 @@ public:
 
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
+		if ((int)len <= 0)
+			return 0;
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		const st_size_t numFrames = len / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, _buffer, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
 		return (obuf - ostart) / 2;
 	}
 
@@ -331,9 +741,11 @@ public:
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, ResampleQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0) {
+		if (quality != kResampleLinear) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate, quality);
+		} else if ((inrate % outrate) == 0) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -346,14 +758,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResampleQuality quality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, quality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, quality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, quality);
 }
 
 } // End of namespace Audio
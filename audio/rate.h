@@ -45,6 +45,21 @@ enum {
 	ST_SUCCESS = 0
 };
 
+/**
+ * Quality tiers for converting between differing sample rates.
+ *
+ * kResampleLinear uses the cheap linear interpolation (or, for integer
+ * ratios, sample dropping) converters. The other tiers use a polyphase
+ * windowed-sinc filter of increasing length, which avoids most of the
+ * aliasing at a higher CPU cost.
+ */
+enum ResampleQuality {
+	kResampleLinear = 0,
+	kResampleSincLow = 1,
+	kResampleSincMedium = 2,
+	kResampleSincHigh = 3
+};
+
 static inline void clampedAdd(int16& a, int b) {
 	register int val;
 #ifdef OUTPUT_UNSIGNED_AUDIO
@@ -78,7 +93,13 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, ResampleQuality quality = kResampleLinear);
+
+/**
+ * Free the filter tables shared by the kResampleSinc* converters. Must only
+ * be called once no such converter is left, e.g. when the mixer is destroyed.
+ */
+void freeSincTables();
 
 } // End of namespace Audio
 
@@ -435,8 +435,11 @@ public:
 
 /**
  * Create and return a RateConverter object for the specified input and output rates.
+ *
+ * The ARM assembler converters only come in one quality, so the
+ * requested quality is ignored.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResampleQuality quality) {
 	if (inrate != outrate) {
 		if ((inrate % outrate) == 0) {
 			if (stereo) {
@@ -158,6 +158,24 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified,
+	 * in seconds since an arbitrary but fixed point in time.
+	 *
+	 * Only useful to tell whether an object changed since it was last looked
+	 * at, backends which cannot determine it simply return 0.
+	 *
+	 * @return the modification time, or 0 if it is unknown
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
+	/**
+	 * Returns the size of the file referred by this path, without opening it.
+	 * Backends which cannot determine it simply return -1.
+	 *
+	 * @return the size of the file in bytes, or -1 if it is unknown
+	 */
+	virtual int32 getFileSize() const { return -1; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
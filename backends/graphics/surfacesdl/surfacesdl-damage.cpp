@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/graphics/surfacesdl/surfacesdl-damage.h"
+#include "common/util.h"
+
+DamageTracker::DamageTracker()
+	: _width(0), _height(0), _tilesW(0), _tilesH(0), _wordsPerRow(0),
+	  _minRow(0), _maxRow(-1) {
+}
+
+void DamageTracker::setSize(int width, int height) {
+	if (width == _width && height == _height)
+		return;
+
+	_width = width;
+	_height = height;
+	_tilesW = (width + kTileSize - 1) >> kTileShift;
+	_tilesH = (height + kTileSize - 1) >> kTileShift;
+	_wordsPerRow = (_tilesW + 31) >> 5;
+
+	_tiles.resize(_wordsPerRow * _tilesH);
+	for (uint i = 0; i < _tiles.size(); ++i)
+		_tiles[i] = 0;
+
+	// A row never holds more than (_tilesW + 1) / 2 separate runs
+	_open.resize(_tilesW);
+	_nextOpen.resize(_tilesW);
+
+	_minRow = 0;
+	_maxRow = -1;
+}
+
+void DamageTracker::clear() {
+	for (int ty = _minRow; ty <= _maxRow; ++ty) {
+		uint32 *row = &_tiles[ty * _wordsPerRow];
+		for (int i = 0; i < _wordsPerRow; ++i)
+			row[i] = 0;
+	}
+
+	_minRow = 0;
+	_maxRow = -1;
+}
+
+void DamageTracker::addRect(int x, int y, int w, int h) {
+	assert(x >= 0 && y >= 0 && w > 0 && h > 0);
+	assert(x + w <= _width && y + h <= _height);
+
+	const int x0 = x >> kTileShift;
+	const int x1 = (x + w - 1) >> kTileShift;
+	const int y0 = y >> kTileShift;
+	const int y1 = (y + h - 1) >> kTileShift;
+
+	for (int ty = y0; ty <= y1; ++ty) {
+		uint32 *row = &_tiles[ty * _wordsPerRow];
+		int tx = x0;
+		while (tx <= x1) {
+			const int bit = tx & 31;
+			const int n = MIN(32 - bit, x1 - tx + 1);
+			row[tx >> 5] |= (n == 32) ? 0xFFFFFFFF : (((1U << n) - 1) << bit);
+			tx += n;
+		}
+	}
+
+	if (isEmpty()) {
+		_minRow = y0;
+		_maxRow = y1;
+	} else {
+		_minRow = MIN(_minRow, y0);
+		_maxRow = MAX(_maxRow, y1);
+	}
+}
+
+bool DamageTracker::findRun(const uint32 *row, int &x, int &end) const {
+	while (x < _tilesW) {
+		const uint32 word = row[x >> 5] >> (x & 31);
+		if (word == 0)
+			x = (x | 31) + 1;
+		else if (word & 1)
+			break;
+		else
+			++x;
+	}
+
+	if (x >= _tilesW)
+		return false;
+
+	// Tiles past the right edge are never set, so the run ends there at
+	// the latest
+	end = x + 1;
+	while (end < _tilesW) {
+		const int bit = end & 31;
+		const uint32 word = row[end >> 5] >> bit;
+		if (word == (0xFFFFFFFF >> bit))
+			end = (end | 31) + 1;
+		else if (word & 1)
+			++end;
+		else
+			break;
+	}
+
+	end = MIN(end, _tilesW);
+	return true;
+}
+
+int DamageTracker::emitRuns(Common::Rect *rects, int maxRects, bool coarse) {
+	int *open = _open.begin();
+	int *nextOpen = _nextOpen.begin();
+	int numOpen = 0;
+	int count = 0;
+
+	for (int ty = _minRow; ty <= _maxRow; ++ty) {
+		const uint32 *row = &_tiles[ty * _wordsPerRow];
+		int numNextOpen = 0;
+		int prev = 0;
+		int x = 0, end = 0;
+
+		while (findRun(row, x, end)) {
+			if (coarse) {
+				int next = end, nextEnd;
+				while (findRun(row, next, nextEnd))
+					next = end = nextEnd;
+			}
+
+			// Continue a rect from the previous row if it covers exactly the
+			// same columns, otherwise start a new one
+			while (prev < numOpen && rects[open[prev]].left < x)
+				++prev;
+
+			if (prev < numOpen && rects[open[prev]].left == x && rects[open[prev]].right == end) {
+				rects[open[prev]].bottom = ty + 1;
+				nextOpen[numNextOpen++] = open[prev++];
+			} else {
+				if (count == maxRects)
+					return -1;
+				rects[count] = Common::Rect(x, ty, end, ty + 1);
+				nextOpen[numNextOpen++] = count++;
+			}
+
+			x = end;
+		}
+
+		SWAP(open, nextOpen);
+		numOpen = numNextOpen;
+	}
+
+	return count;
+}
+
+int DamageTracker::emitRects(Common::Rect *rects, int maxRects) {
+	assert(maxRects > 0);
+
+	if (isEmpty())
+		return 0;
+
+	int count = emitRuns(rects, maxRects, false);
+	if (count < 0)
+		count = emitRuns(rects, maxRects, true);
+	if (count < 0) {
+		rects[0] = Common::Rect(0, _minRow, _tilesW, _maxRow + 1);
+		count = 1;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		Common::Rect &r = rects[i];
+		r.left <<= kTileShift;
+		r.top <<= kTileShift;
+		r.right = MIN<int>(r.right << kTileShift, _width);
+		r.bottom = MIN<int>(r.bottom << kTileShift, _height);
+	}
+
+	clear();
+	return count;
+}
@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_DAMAGE_H
+#define BACKENDS_GRAPHICS_SURFACESDL_DAMAGE_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+/**
+ * Collects the dirty areas of a surface in a bitmap of square tiles.
+ *
+ * Any number of rects can be added per frame without running out of
+ * space; overlapping and adjacent rects automatically end up in the same
+ * tiles. emitRects() then turns the bitmap into a small set of
+ * non-overlapping rects, so every pixel is scaled at most once per frame
+ * and a handful of sprites does not escalate to a full screen update.
+ */
+class DamageTracker {
+public:
+	enum {
+		kTileShift = 3,
+		kTileSize = 1 << kTileShift
+	};
+
+	DamageTracker();
+
+	/**
+	 * Set the size of the tracked surface. Any pending damage is dropped
+	 * if the size changes.
+	 */
+	void setSize(int width, int height);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+
+	bool isEmpty() const { return _minRow > _maxRow; }
+
+	/** Drop all pending damage. */
+	void clear();
+
+	/**
+	 * Mark an area as dirty. The rect has to lie within the surface
+	 * and must not be empty.
+	 */
+	void addRect(int x, int y, int w, int h);
+
+	/**
+	 * Turn the pending damage into a set of non-overlapping rects,
+	 * clipped to the surface, and clear it afterwards.
+	 *
+	 * Horizontally adjacent tiles are joined into runs, and runs which
+	 * span the same columns on consecutive rows into one rect. If that
+	 * needs more than maxRects rects, coarser rects covering some clean
+	 * tiles are used instead.
+	 *
+	 * @return the number of rects written to rects
+	 */
+	int emitRects(Common::Rect *rects, int maxRects);
+
+private:
+	/** Emit tile runs, or only one run per row if coarse is set. */
+	int emitRuns(Common::Rect *rects, int maxRects, bool coarse);
+	/** Find the next run of dirty tiles in row starting at column x or later. */
+	bool findRun(const uint32 *row, int &x, int &end) const;
+
+	int _width, _height;
+	int _tilesW, _tilesH;
+	int _wordsPerRow;
+	int _minRow, _maxRow;
+
+	Common::Array<uint32> _tiles;
+
+	// Indices of the rects which ended on the previous row, resp. the
+	// current row, ordered by their left edge
+	Common::Array<int> _open, _nextOpen;
+};
+
+#endif
@@ -133,7 +133,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_overlayVisible(false),
 	_overlayscreen(0), _tmpscreen2(0),
-	_scalerProc(0), _screenChangeCount(0),
+	_scalerProc(0), _scalerPool(0), _screenChangeCount(0), _numDirtyRects(0), _numAddedRects(0),
 	_mouseVisible(false), _mouseNeedsRedraw(false), _mouseData(0), _mouseSurface(0),
 	_mouseOrigSurface(0), _cursorTargetScale(1), _cursorPaletteDisabled(true),
 	_currentShakePos(0), _newShakePos(0),
@@ -160,6 +160,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_mouseBackup.x = _mouseBackup.y = _mouseBackup.w = _mouseBackup.h = 0;
 
 	memset(&_mouseCurState, 0, sizeof(_mouseCurState));
+	memset(&_damageStats, 0, sizeof(_damageStats));
 
 	_graphicsMutex = g_system->createMutex();
 
@@ -168,6 +169,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
 #endif
 
+	_scalerPool = new ScalerThreadPool(ConfMan.getInt("scaler_threads"));
+
 	SDL_ShowCursor(SDL_DISABLE);
 
 	memset(&_oldVideoMode, 0, sizeof(_oldVideoMode));
@@ -208,6 +211,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 		SDL_FreeSurface(_mouseOrigSurface);
 	_mouseOrigSurface = 0;
 	g_system->deleteMutex(_graphicsMutex);
+	delete _scalerPool;
 
 	free(_currentPalette);
 	free(_cursorPalette);
@@ -1039,6 +1043,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	flushDirtyRects();
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -1088,8 +1094,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
-					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
+				_scalerPool->scale(scalerProc, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h, scale1);
 			}
 
 			r->x = rx1;
@@ -1337,11 +1343,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceFull)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceFull = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1391,14 +1392,98 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+	if (w <= 0 || h <= 0)
+		return;
+
+	if (realCoordinates) {
+		// Real coordinates are only used by drawMouse(), after the screen
+		// has been scaled, so there is nothing left to merge these with.
+		if (_numDirtyRects == NUM_DIRTY_RECT) {
+			SDL_Rect *r = &_dirtyRectList[NUM_DIRTY_RECT - 1];
+			const int right = MAX(r->x + r->w, x + w);
+			const int bottom = MAX(r->y + r->h, y + h);
+			r->x = MIN<int>(r->x, x);
+			r->y = MIN<int>(r->y, y);
+			r->w = right - r->x;
+			r->h = bottom - r->y;
+		} else {
+			SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+			r->x = x;
+			r->y = y;
+			r->w = w;
+			r->h = h;
+		}
+		return;
+	}
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+	// Damage collected for a different screen size can't be drawn anymore
+	if (width != _damage.getWidth() || height != _damage.getHeight()) {
+		if (!_damage.isEmpty()) {
+			_damage.clear();
+			_forceFull = true;
+			return;
+		}
+		_damage.setSize(width, height);
 	}
+
+	_damage.addRect(x, y, w, h);
+	++_numAddedRects;
+}
+
+void SurfaceSdlGraphicsManager::flushDirtyRects() {
+	uint32 pixels = 0;
+
+	// Leave some room for the mouse cursor, which is added after scaling
+	const int maxRects = NUM_DIRTY_RECT - _numDirtyRects - 4;
+
+	// Without room for the damaged areas, redraw the whole screen instead
+	if (maxRects <= 0 && !_damage.isEmpty())
+		_forceFull = true;
+
+	if (_forceFull) {
+		_damage.clear();
+
+		if (!_overlayVisible)
+			pixels = _videoMode.screenWidth * _videoMode.screenHeight;
+		else
+			pixels = _videoMode.overlayWidth * _videoMode.overlayHeight;
+
+		_damageStats.rectsDrawn = 1;
+		++_damageStats.fullFrames;
+	} else {
+		if (_damage.isEmpty())
+			return;
+
+		Common::Rect rects[NUM_DIRTY_RECT];
+		const int count = _damage.emitRects(rects, maxRects);
+
+		for (int i = 0; i < count; ++i) {
+			int x = rects[i].left, y = rects[i].top;
+			int w = rects[i].width(), h = rects[i].height();
+
+#ifdef USE_SCALERS
+			// Stretchable rects don't stay stretchable when snapped to tiles
+			if (_videoMode.aspectRatioCorrection && !_overlayVisible)
+				makeRectStretchable(x, y, w, h);
+#endif
+
+			SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+			r->x = x;
+			r->y = y;
+			r->w = w;
+			r->h = h;
+
+			pixels += w * h;
+		}
+
+		_damageStats.rectsDrawn = count;
+	}
+
+	++_damageStats.frames;
+	_damageStats.rectsAdded = _numAddedRects;
+	_damageStats.pixelsScaled = pixels;
+	_damageStats.avgPixelsScaled += ((int32)pixels - (int32)_damageStats.avgPixelsScaled) / 16;
+	_numAddedRects = 0;
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() {
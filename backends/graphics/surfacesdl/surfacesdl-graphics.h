@@ -25,6 +25,8 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "backends/graphics/surfacesdl/surfacesdl-damage.h"
+#include "backends/graphics/surfacesdl/surfacesdl-scaler.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -105,6 +107,18 @@ public:
 	virtual int16 getHeight();
 	virtual int16 getWidth();
 
+	/** Counters describing how much of the screen had to be redrawn. */
+	struct DamageStats {
+		uint32 frames;          ///< Number of screen updates which redrew anything
+		uint32 fullFrames;      ///< Number of those which redrew the whole screen
+		uint rectsAdded;        ///< Dirty rects added before the last update
+		uint rectsDrawn;        ///< Rects the last update was split into
+		uint32 pixelsScaled;    ///< Game (or overlay) pixels scaled by the last update
+		uint32 avgPixelsScaled; ///< Running average of pixelsScaled
+	};
+
+	const DamageStats &getDamageStats() const { return _damageStats; }
+
 protected:
 	// PaletteManager API
 	virtual void setPalette(const byte *colors, uint start, uint num);
@@ -229,6 +243,8 @@ protected:
 	bool _forceFull;
 
 	ScalerProc *_scalerProc;
+	/** Runs _scalerProc on several threads */
+	ScalerThreadPool *_scalerPool;
 	int _scalerType;
 	int _transactionMode;
 
@@ -242,9 +258,14 @@ protected:
 		MAX_SCALING = 3
 	};
 
-	// Dirty rect management
+	// Dirty rect management. Rects in game (or overlay) coordinates are
+	// collected in _damage and only turned into _dirtyRectList, the list
+	// of areas to scale and update, by flushDirtyRects().
+	DamageTracker _damage;
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
+	uint _numAddedRects;
+	DamageStats _damageStats;
 
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
@@ -314,6 +335,13 @@ protected:
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
 
+	/**
+	 * Move the damage collected since the last update into _dirtyRectList
+	 * and update the damage counters. Has to be called by internUpdateScreen()
+	 * before the list is used.
+	 */
+	void flushDirtyRects();
+
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
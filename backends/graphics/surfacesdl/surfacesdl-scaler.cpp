@@ -0,0 +1,189 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX)
+#include <unistd.h>
+#endif
+
+#include "backends/graphics/surfacesdl/surfacesdl-scaler.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+enum {
+	// More threads hardly help, since the screen update as a whole is
+	// limited by memory bandwidth long before that
+	kMaxScalerThreads = 8
+};
+
+static int getNumCPUs() {
+#if SDL_VERSION_ATLEAST(1, 3, 0)
+	return SDL_GetCPUCount();
+#elif defined(POSIX) && defined(_SC_NPROCESSORS_ONLN)
+	return sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	return 1;
+#endif
+}
+
+ScalerThreadPool::ScalerThreadPool(int numThreads)
+	: _mutex(0), _workCond(0), _doneCond(0), _nextBand(0), _bandsLeft(0),
+	  _generation(0), _quit(false) {
+
+	if (numThreads <= 0)
+		numThreads = getNumCPUs();
+	numThreads = CLIP<int>(numThreads, 1, kMaxScalerThreads);
+
+	memset(&_job, 0, sizeof(_job));
+
+	if (numThreads == 1)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+
+	for (int i = 1; i < numThreads; ++i) {
+		SDL_Thread *thread = SDL_CreateThread(workerThreadEntry, this);
+		if (!thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+ScalerThreadPool::~ScalerThreadPool() {
+	if (!_mutex)
+		return;
+
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_workCond);
+	SDL_UnlockMutex(_mutex);
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		SDL_WaitThread(_threads[i], NULL);
+
+	SDL_DestroyCond(_doneCond);
+	SDL_DestroyCond(_workCond);
+	SDL_DestroyMutex(_mutex);
+}
+
+bool ScalerThreadPool::isThreadSafe(ScalerProc *proc) {
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembler versions of the HQ scalers keep their state in
+	// global variables
+	if (proc == HQ2x || proc == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+void ScalerThreadPool::scale(ScalerProc *proc, const uint8 *srcPtr, uint32 srcPitch,
+                             uint8 *dstPtr, uint32 dstPitch, int width, int height, int factor) {
+	// Aim for two bands per thread, so that a thread which got the busy
+	// part of the screen does not hold up all the others
+	int bandHeight = (height + 2 * getNumThreads() - 1) / (2 * getNumThreads());
+	bandHeight = MAX<int>((bandHeight + kBandAlign - 1) & ~(kBandAlign - 1), kMinBandHeight);
+
+	const int numBands = height / bandHeight;
+
+	if (_threads.empty() || numBands < 2 || width * height < kMinParallelPixels || !isThreadSafe(proc)) {
+		proc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+
+	_job.proc = proc;
+	_job.srcPtr = srcPtr;
+	_job.srcPitch = srcPitch;
+	_job.dstPtr = dstPtr;
+	_job.dstPitch = dstPitch;
+	_job.width = width;
+	_job.height = height;
+	_job.factor = factor;
+	_job.bandHeight = bandHeight;
+	_job.numBands = numBands;
+
+	_nextBand = 0;
+	_bandsLeft = numBands;
+	++_generation;
+	SDL_CondBroadcast(_workCond);
+
+	processBands();
+
+	while (_bandsLeft > 0)
+		SDL_CondWait(_doneCond, _mutex);
+
+	SDL_UnlockMutex(_mutex);
+}
+
+void ScalerThreadPool::processBands() {
+	while (_nextBand < _job.numBands) {
+		const Job job = _job;
+		const int band = _nextBand++;
+
+		SDL_UnlockMutex(_mutex);
+
+		// The last band also takes the rows which did not make up a
+		// full band
+		const int y = band * job.bandHeight;
+		const int h = (band == job.numBands - 1) ? job.height - y : job.bandHeight;
+
+		job.proc(job.srcPtr + y * job.srcPitch, job.srcPitch,
+		         job.dstPtr + y * job.factor * job.dstPitch, job.dstPitch, job.width, h);
+
+		SDL_LockMutex(_mutex);
+
+		if (--_bandsLeft == 0)
+			SDL_CondSignal(_doneCond);
+	}
+}
+
+int SDLCALL ScalerThreadPool::workerThreadEntry(void *arg) {
+	ScalerThreadPool *pool = (ScalerThreadPool *)arg;
+	assert(pool);
+	pool->workerThread();
+	return 0;
+}
+
+void ScalerThreadPool::workerThread() {
+	uint generation = 0;
+
+	SDL_LockMutex(_mutex);
+	while (true) {
+		while (!_quit && _generation == generation)
+			SDL_CondWait(_workCond, _mutex);
+
+		if (_quit)
+			break;
+
+		generation = _generation;
+		processBands();
+	}
+	SDL_UnlockMutex(_mutex);
+}
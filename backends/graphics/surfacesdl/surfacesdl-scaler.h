@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALER_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALER_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/array.h"
+#include "common/noncopyable.h"
+#include "graphics/scaler.h"
+
+/**
+ * Runs a ScalerProc on several threads at once.
+ *
+ * The area to scale is cut into horizontal bands, which are passed to
+ * the scaler one by one. All scalers only read the source surface, up to
+ * two rows past either end of the area they are given, so the bands can
+ * share the source without copying any overlap rows, and each writes a
+ * disjoint part of the destination. The result is identical to scaling
+ * the whole area with a single call.
+ *
+ * The calling thread scales bands as well, and scale() only returns once
+ * the whole area is done.
+ */
+class ScalerThreadPool : Common::NonCopyable {
+public:
+	enum {
+		/**
+		 * Bands start at multiples of this many rows, which keeps the
+		 * row pattern of the DotMatrix scaler in place.
+		 */
+		kBandAlign = 4,
+		/** Minimum height of a band, some scalers need at least 2 rows. */
+		kMinBandHeight = 16,
+		/** Areas with fewer pixels are not worth splitting. */
+		kMinParallelPixels = 16 * 1024
+	};
+
+	/**
+	 * @param numThreads	number of threads to scale on, including the
+	 *                      calling one. 0 picks the number of CPUs.
+	 */
+	ScalerThreadPool(int numThreads);
+	~ScalerThreadPool();
+
+	/** Number of threads scaling, including the calling one. */
+	int getNumThreads() const { return _threads.size() + 1; }
+
+	/**
+	 * Scale an area, with the same arguments as the ScalerProc itself.
+	 *
+	 * @param factor	number of destination rows per source row
+	 */
+	void scale(ScalerProc *proc, const uint8 *srcPtr, uint32 srcPitch,
+	           uint8 *dstPtr, uint32 dstPitch, int width, int height, int factor);
+
+private:
+	struct Job {
+		ScalerProc *proc;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width, height, factor;
+		int bandHeight, numBands;
+	};
+
+	static int SDLCALL workerThreadEntry(void *arg);
+	void workerThread();
+
+	/** Scale bands until none is left. Needs _mutex to be locked. */
+	void processBands();
+
+	static bool isThreadSafe(ScalerProc *proc);
+
+	Common::Array<SDL_Thread *> _threads;
+	SDL_mutex *_mutex;
+	SDL_cond *_workCond;
+	SDL_cond *_doneCond;
+
+	Job _job;
+	int _nextBand;
+	int _bandsLeft;
+	uint _generation;
+	bool _quit;
+};
+
+#endif
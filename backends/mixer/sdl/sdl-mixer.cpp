@@ -29,6 +29,7 @@
 #include "common/system.h"
 #include "common/config-manager.h"
 #include "common/textconsole.h"
+#include "common/util.h"
 
 #ifdef GP2X
 #define SAMPLES_PER_SEC 11025
@@ -93,6 +94,8 @@ void SdlMixerManager::init() {
 
 		_mixer = new Audio::MixerImpl(g_system, _obtained.freq);
 		assert(_mixer);
+		_mixer->setLockFree(ConfMan.getBool("lockfree_mixer"));
+		_mixer->setResampleQuality((Audio::ResampleQuality)CLIP(ConfMan.getInt("resample_quality"), (int)Audio::kResampleLinear, (int)Audio::kResampleSincHigh));
 		_mixer->setReady(true);
 
 		startAudio();
@@ -22,7 +22,9 @@
 #include "common/scummsys.h"
 #include "backends/timer/default/default-timer.h"
 #include "common/util.h"
+#include "common/debug.h"
 #include "common/system.h"
+#include "common/textconsole.h"
 
 struct TimerSlot {
 	Common::TimerManager::TimerProc callback;
@@ -30,82 +32,154 @@ struct TimerSlot {
 	Common::String id;
 	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint32 nextFireTime;	// in microseconds
+	uint heapIndex;	// position in DefaultTimerManager::_heap
 
-	TimerSlot *next;
+	uint32 fireCount;
+	uint32 avgLateness;	// in microseconds
+	uint32 maxLateness;	// in microseconds
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+/**
+ * Compares two fire times, taking the wrap-around of the microsecond
+ * clock into account.
+ */
+static inline bool firesBefore(const TimerSlot *a, const TimerSlot *b) {
+	return (int32)(a->nextFireTime - b->nextFireTime) < 0;
 }
 
 
 DefaultTimerManager::DefaultTimerManager() :
-	_timerHandler(0),
-	_head(0) {
-
-	_head = new TimerSlot();
-	memset(_head, 0, sizeof(TimerSlot));
+	_timerHandler(0) {
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+	for (uint i = 0; i < _heap.size(); ++i)
+		delete _heap[i];
+	_heap.clear();
+}
+
+uint32 DefaultTimerManager::getMicroseconds() {
+	return g_system->getMillis() * 1000;
+}
+
+void DefaultTimerManager::heapSet(uint index, TimerSlot *slot) {
+	_heap[index] = slot;
+	slot->heapIndex = index;
+}
+
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _heap[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!firesBefore(slot, _heap[parent]))
+			break;
+		heapSet(index, _heap[parent]);
+		index = parent;
+	}
+	heapSet(index, slot);
+}
+
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _heap[index];
+	const uint size = _heap.size();
+	while (true) {
+		uint child = 2 * index + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && firesBefore(_heap[child + 1], _heap[child]))
+			child++;
+		if (!firesBefore(_heap[child], slot))
+			break;
+		heapSet(index, _heap[child]);
+		index = child;
 	}
-	_head = 0;
+	heapSet(index, slot);
+}
+
+void DefaultTimerManager::heapInsert(TimerSlot *slot) {
+	_heap.push_back(slot);
+	siftUp(_heap.size() - 1);
+}
+
+void DefaultTimerManager::heapRemove(TimerSlot *slot) {
+	const uint index = slot->heapIndex;
+	assert(index < _heap.size() && _heap[index] == slot);
+
+	TimerSlot *last = _heap.back();
+	_heap.pop_back();
+	if (last == slot)
+		return;
+
+	// Move the last slot into the hole, then restore the heap order in
+	// whichever direction it is violated.
+	heapSet(index, last);
+	if (index > 0 && firesBefore(last, _heap[(index - 1) / 2]))
+		siftUp(index);
+	else
+		siftDown(index);
 }
 
 void DefaultTimerManager::handler() {
 	Common::StackLock lock(_mutex);
 
-	const uint32 curTime = g_system->getMillis();
+	const uint32 curTime = getMicroseconds();
 
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
+	while (!_heap.empty()) {
+		TimerSlot *slot = _heap.front();
+		const int32 lateness = (int32)(curTime - slot->nextFireTime);
+		if (lateness < 0)
+			break;
+
+		// Keep track of how far off the schedule we are
+		slot->fireCount++;
+		if (slot->fireCount == 1)
+			slot->avgLateness = lateness;
+		else
+			slot->avgLateness = (slot->avgLateness * 15 + lateness) / 16;
+		if ((uint32)lateness > slot->maxLateness)
+			slot->maxLateness = lateness;
+
+		// Advance the fire time by exactly one interval, so that no error
+		// accumulates, and move the slot down to its new place.
 		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
-		}
-		insertPrioQueue(_head, slot);
+		slot->nextFireTime += slot->interval;
+		siftDown(0);
 
-		// Invoke the timer callback
+		// Invoke the timer callback. The callback may remove its own timer,
+		// so don't touch the slot afterwards.
 		assert(slot->callback);
 		slot->callback(slot->refCon);
+	}
+}
+
+uint32 DefaultTimerManager::getMicrosUntilNextTimer(uint32 maxWait) {
+	Common::StackLock lock(_mutex);
+
+	if (_heap.empty())
+		return maxWait;
+
+	const int32 delta = (int32)(_heap.front()->nextFireTime - getMicroseconds());
+	return (delta > 0) ? MIN<uint32>(delta, maxWait) : 0;
+}
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+void DefaultTimerManager::getTimerStats(Common::Array<TimerStats> &stats) {
+	Common::StackLock lock(_mutex);
+
+	stats.clear();
+	for (uint i = 0; i < _heap.size(); ++i) {
+		const TimerSlot *slot = _heap[i];
+
+		TimerStats entry;
+		entry.id = slot->id;
+		entry.interval = slot->interval;
+		entry.fireCount = slot->fireCount;
+		entry.avgLateness = slot->avgLateness;
+		entry.maxLateness = slot->maxLateness;
+		stats.push_back(entry);
 	}
 }
 
@@ -118,12 +192,9 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 			error("Different callbacks are referred by same name (%s)", id.c_str());
 		}
 	}
-	TimerSlotMap::const_iterator i;
 
-	for (i = _callbacks.begin(); i != _callbacks.end(); ++i) {
-		if (i->_value == callback) {
-			error("Same callback added twice (old name: %s, new name: %s)", i->_key.c_str(), id.c_str());
-		}
+	if (_slots.contains(callback)) {
+		error("Same callback added twice (old name: %s, new name: %s)", _slots[callback]->id.c_str(), id.c_str());
 	}
 	_callbacks[id] = callback;
 
@@ -132,11 +203,14 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
+	slot->nextFireTime = getMicroseconds() + interval;
+	slot->heapIndex = 0;
+	slot->fireCount = 0;
+	slot->avgLateness = 0;
+	slot->maxLateness = 0;
 
-	insertPrioQueue(_head, slot);
+	_slots[callback] = slot;
+	heapInsert(slot);
 
 	return true;
 }
@@ -144,17 +218,16 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+	TimerProcMap::iterator i = _slots.find(callback);
+	if (i == _slots.end())
+		return;
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
-		}
-	}
+	TimerSlot *slot = i->_value;
+	_slots.erase(i);
+	heapRemove(slot);
+
+	debug(2, "Timer '%s' removed after %u invocations, lateness: %u us average, %u us max",
+	      slot->id.c_str(), slot->fireCount, slot->avgLateness, slot->maxLateness);
 
 	// We need to remove all names referencing the timer proc here.
 	// 
@@ -168,8 +241,10 @@ void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	// name and causing installTimerProc to error out.
 	// A good test case is running a SCUMM with ALSA output and then a KYRA
 	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
-	}
+	//
+	// Since a callback can only be installed once, the slot's id is the
+	// only name which can refer to it.
+	_callbacks.erase(slot->id);
+
+	delete slot;
 }
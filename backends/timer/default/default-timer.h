@@ -22,6 +22,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -29,14 +30,48 @@
 
 struct TimerSlot;
 
+/**
+ * Timer manager which runs all timers from a single backend callback.
+ *
+ * Timers are kept in a binary min-heap ordered by their next fire time,
+ * so installing, removing and firing a timer all take O(log n). Fire
+ * times are kept in microseconds and advanced by exactly one interval
+ * per invocation, so timers do not drift even if the backend invokes
+ * handler() irregularly.
+ */
 class DefaultTimerManager : public Common::TimerManager {
+public:
+	/**
+	 * How accurately a timer fired so far. Lateness is measured from the
+	 * scheduled fire time to the actual invocation, in microseconds.
+	 */
+	struct TimerStats {
+		Common::String id;
+		uint32 interval;
+		uint32 fireCount;
+		uint32 avgLateness;	///< average over roughly the last 16 invocations
+		uint32 maxLateness;
+	};
+
 private:
+	struct TimerProcHash {
+		uint operator()(TimerProc proc) const { return (uint)(size_t)proc; }
+	};
+
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
+	typedef Common::HashMap<TimerProc, TimerSlot *, TimerProcHash> TimerProcMap;
 
 	Common::Mutex _mutex;
 	void *_timerHandler;
-	TimerSlot *_head;
+	Common::Array<TimerSlot *> _heap;
 	TimerSlotMap _callbacks;
+	TimerProcMap _slots;
+
+	void heapInsert(TimerSlot *slot);
+	void heapRemove(TimerSlot *slot);
+	void siftUp(uint index);
+	void siftDown(uint index);
+	void heapSet(uint index, TimerSlot *slot);
 
 public:
 	DefaultTimerManager();
@@ -48,6 +83,30 @@ public:
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
 	void handler();
+
+	/**
+	 * Returns how many microseconds are left until the next timer is due,
+	 * or 0 if one is due already. Backends can use this to invoke
+	 * handler() just in time, rather than at a fixed rate.
+	 *
+	 * @param maxWait	value to return if no timer is installed
+	 */
+	uint32 getMicrosUntilNextTimer(uint32 maxWait);
+
+	/**
+	 * Fills stats with the jitter statistics of all installed timers.
+	 */
+	void getTimerStats(Common::Array<TimerStats> &stats);
+
+protected:
+	/**
+	 * Monotonic clock all fire times are based on, in microseconds. It
+	 * may wrap around; only differences between two values are used.
+	 *
+	 * The default implementation is based on OSystem::getMillis(),
+	 * backends with access to a finer clock should override it.
+	 */
+	virtual uint32 getMicroseconds();
 };
 
 #endif
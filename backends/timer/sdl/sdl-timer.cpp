@@ -21,6 +21,9 @@
  *
  */
 
+// Needed for clock_gettime
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
 #include "common/scummsys.h"
 
 #if defined(SDL_BACKEND)
@@ -28,10 +31,21 @@
 #include "backends/timer/sdl/sdl-timer.h"
 
 #include "common/textconsole.h"
+#include "common/util.h"
+
+#if defined(POSIX)
+#include <time.h>
+#endif
 
 static Uint32 timer_handler(Uint32 interval, void *param) {
-	((DefaultTimerManager *)param)->handler();
-	return interval;
+	DefaultTimerManager *manager = (DefaultTimerManager *)param;
+	manager->handler();
+
+	// Come back when the next timer is due, but at least every 10ms so
+	// that newly installed timers get picked up. SDL rounds this to its
+	// own timer resolution.
+	const uint32 wait = manager->getMicrosUntilNextTimer(10000);
+	return MAX<uint32>(1, (wait + 999) / 1000);
 }
 
 SdlTimerManager::SdlTimerManager() {
@@ -49,4 +63,15 @@ SdlTimerManager::~SdlTimerManager() {
 	SDL_RemoveTimer(_timerID);
 }
 
+uint32 SdlTimerManager::getMicroseconds() {
+#if defined(POSIX) && defined(CLOCK_MONOTONIC)
+	// SDL 1.2 only offers a millisecond clock, which is also affected by
+	// changes of the system time on some platforms.
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+		return (uint32)ts.tv_sec * 1000000 + (uint32)(ts.tv_nsec / 1000);
+#endif
+	return SDL_GetTicks() * 1000;
+}
+
 #endif
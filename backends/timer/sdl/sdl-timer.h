@@ -38,6 +38,8 @@ public:
 
 protected:
 	SDL_TimerID _timerID;
+
+	virtual uint32 getMicroseconds();
 };
 
 
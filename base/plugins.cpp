@@ -542,6 +542,7 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 // Engine plugins
 
+#include "engines/advancedDetector.h"
 #include "engines/metaengine.h"
 
 namespace Common {
@@ -625,6 +626,10 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 			candidates.push_back((**iter)->detectGames(fslist));
 		}
 	} while (PluginManager::instance().loadNextPlugin());
+
+	// Only write the checksums back once all engines are done with them
+	AdvancedMetaEngine::saveDetectionCache();
+
 	return candidates;
 }
 
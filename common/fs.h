@@ -205,6 +205,22 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Returns the time the object referred by this node was last modified,
+	 * in seconds since an arbitrary but fixed point in time. This is only
+	 * good for telling whether the object changed in the meantime.
+	 *
+	 * @return the modification time, or 0 if it is unknown
+	 */
+	uint32 getModificationTime() const;
+
+	/**
+	 * Returns the size of the file referred by this node, without opening it.
+	 *
+	 * @return the size of the file in bytes, or -1 if it is unknown
+	 */
+	int32 getFileSize() const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_LOCKFREE_QUEUE_H
+#define COMMON_LOCKFREE_QUEUE_H
+
+#include "common/scummsys.h"
+#include "common/memorybarrier.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * Fixed size FIFO for passing values from exactly one producer thread
+ * to exactly one consumer thread without any locking.
+ *
+ * Neither side ever waits for the other: push() fails if the queue is
+ * full and pop() fails if it is empty. If several threads need to push
+ * (or pop), they have to serialize among themselves, e.g. with a
+ * Common::Mutex which the other side never touches.
+ *
+ * One slot is kept unused to tell a full queue from an empty one, so at
+ * most N - 1 values can be queued at a time.
+ */
+template<class T, uint N>
+class LockFreeQueue : NonCopyable {
+public:
+	LockFreeQueue() : _head(0), _tail(0) {}
+
+	/** Only reliable when called from the consumer thread. */
+	bool empty() const {
+		return _head == _tail;
+	}
+
+	/** Only reliable when called from the producer thread. */
+	bool full() const {
+		return next(_tail) == _head;
+	}
+
+	/**
+	 * Append a value. Must only be called from the producer thread.
+	 *
+	 * @return false if the queue is full, true otherwise.
+	 */
+	bool push(const T &x) {
+		const uint tail = _tail;
+		if (next(tail) == _head)
+			return false;
+
+		_storage[tail] = x;
+		// The value has to be in place before the consumer can see it
+		memoryBarrier();
+		_tail = next(tail);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest value. Must only be called from the consumer thread.
+	 *
+	 * @return false if the queue is empty, true otherwise.
+	 */
+	bool pop(T &x) {
+		const uint head = _head;
+		if (head == _tail)
+			return false;
+
+		memoryBarrier();
+		x = _storage[head];
+		// The value has to be read before the producer may overwrite it
+		memoryBarrier();
+		_head = next(head);
+		return true;
+	}
+
+private:
+	static uint next(uint pos) {
+		return (pos + 1) % N;
+	}
+
+	T _storage[N];
+	volatile uint _head;
+	volatile uint _tail;
+};
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,55 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_MEMORYBARRIER_H
+#define COMMON_MEMORYBARRIER_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+extern "C" void _ReadWriteBarrier();
+#pragma intrinsic(_ReadWriteBarrier)
+#endif
+
+namespace Common {
+
+/**
+ * Make sure all memory accesses issued before the call are visible to
+ * other threads before any access issued after it.
+ *
+ * On compilers we know nothing about, this only relies on the volatile
+ * accesses in the callers, which is sufficient for the single core
+ * targets those compilers are used for.
+ */
+inline void memoryBarrier() {
+#if GCC_ATLEAST(4, 1)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	// All x86 stores are seen in program order, so it is enough to
+	// keep the compiler from reordering.
+	_ReadWriteBarrier();
+#endif
+}
+
+} // End of namespace Common
+
+#endif
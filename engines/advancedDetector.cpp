@@ -27,6 +27,8 @@
 #include "common/macresman.h"
 #include "common/md5.h"
 #include "common/config-manager.h"
+#include "common/savefile.h"
+#include "common/singleton.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -132,6 +134,191 @@ bool cleanupPirated(ADGameDescList &matched) {
 }
 
 
+/**
+ * Remembers the sizes and MD5 sums of the files looked at during detection.
+ *
+ * All engines share it, so each file is only read once when several engines
+ * check it, and it is kept in the savefile named by the "detection_cache"
+ * config key between runs. An entry is only used again if the file still has
+ * the same modification time and size, so files for which the backend cannot
+ * tell these are never cached.
+ */
+class DetectionMD5Cache : public Common::Singleton<DetectionMD5Cache> {
+public:
+	/**
+	 * Look up the size and MD5 sum of the first md5Bytes bytes of a file.
+	 * Returns false if they are not known for the current version of it.
+	 */
+	bool lookup(const Common::FSNode &node, uint md5Bytes, int32 &size, Common::String &md5);
+
+	/** Remember the size and MD5 sum computed for a file. */
+	void store(const Common::FSNode &node, uint md5Bytes, int32 size, const Common::String &md5);
+
+	/** Write the cache back to its savefile, if anything changed. */
+	void save();
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	DetectionMD5Cache() : _loaded(false), _dirty(false) {}
+
+	enum {
+		kFileVersion = 2,
+		/** Upper limit for the number of entries, to keep the file small. */
+		kMaxEntries = 8192
+	};
+
+	struct Entry {
+		uint32 mtime;
+		int32 fileSize;
+		int32 size;
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(const Common::FSNode &node, uint md5Bytes);
+	static Common::String readString(Common::SeekableReadStream &stream);
+	static void writeString(Common::WriteStream &stream, const Common::String &str);
+
+	void load();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+};
+
+namespace Common {
+DECLARE_SINGLETON(DetectionMD5Cache);
+}
+
+Common::String DetectionMD5Cache::makeKey(const Common::FSNode &node, uint md5Bytes) {
+	return Common::String::format("%u:", md5Bytes) + node.getPath();
+}
+
+bool DetectionMD5Cache::lookup(const Common::FSNode &node, uint md5Bytes, int32 &size, Common::String &md5) {
+	const uint32 mtime = node.getModificationTime();
+	const int32 fileSize = node.getFileSize();
+	if (!mtime || fileSize < 0)
+		return false;
+
+	load();
+
+	EntryMap::const_iterator i = _entries.find(makeKey(node, md5Bytes));
+	if (i == _entries.end() || i->_value.mtime != mtime || i->_value.fileSize != fileSize)
+		return false;
+
+	size = i->_value.size;
+	md5 = i->_value.md5;
+	return true;
+}
+
+void DetectionMD5Cache::store(const Common::FSNode &node, uint md5Bytes, int32 size, const Common::String &md5) {
+	const uint32 mtime = node.getModificationTime();
+	const int32 fileSize = node.getFileSize();
+	if (!mtime || fileSize < 0)
+		return;
+
+	load();
+
+	// Rather than tracking which entries are still in use, start over
+	// once the cache gets too big
+	if (_entries.size() >= kMaxEntries)
+		_entries.clear();
+
+	Entry &entry = _entries[makeKey(node, md5Bytes)];
+	entry.mtime = mtime;
+	entry.fileSize = fileSize;
+	entry.size = size;
+	entry.md5 = md5;
+	_dirty = true;
+}
+
+Common::String DetectionMD5Cache::readString(Common::SeekableReadStream &stream) {
+	Common::String str;
+	for (uint len = stream.readUint16LE(); len > 0 && !stream.eos(); --len)
+		str += (char)stream.readByte();
+	return str;
+}
+
+void DetectionMD5Cache::writeString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint16LE(str.size());
+	stream.write(str.c_str(), str.size());
+}
+
+void DetectionMD5Cache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	const Common::String &filename = ConfMan.get("detection_cache");
+	if (filename.empty())
+		return;
+
+	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(filename);
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != MKTAG('D', 'M', 'D', '5') || in->readUint32LE() != kFileVersion) {
+		warning("Ignoring detection cache '%s' of unknown format", filename.c_str());
+		delete in;
+		return;
+	}
+
+	const uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && i < kMaxEntries; ++i) {
+		const Common::String key = readString(*in);
+		Entry entry;
+		entry.mtime = in->readUint32LE();
+		entry.fileSize = in->readSint32LE();
+		entry.size = in->readSint32LE();
+		entry.md5 = readString(*in);
+
+		if (in->eos() || in->err()) {
+			warning("Detection cache '%s' is truncated", filename.c_str());
+			_entries.clear();
+			break;
+		}
+
+		_entries[key] = entry;
+	}
+
+	delete in;
+	debug(3, "Loaded %u entries from detection cache '%s'", _entries.size(), filename.c_str());
+}
+
+void DetectionMD5Cache::save() {
+	if (!_dirty)
+		return;
+	_dirty = false;
+
+	const Common::String &filename = ConfMan.get("detection_cache");
+	if (filename.empty())
+		return;
+
+	Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(filename);
+	if (!out) {
+		warning("Could not write detection cache '%s'", filename.c_str());
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('D', 'M', 'D', '5'));
+	out->writeUint32LE(kFileVersion);
+	out->writeUint32LE(_entries.size());
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		writeString(*out, i->_key);
+		out->writeUint32LE(i->_value.mtime);
+		out->writeSint32LE(i->_value.fileSize);
+		out->writeSint32LE(i->_value.size);
+		writeString(*out, i->_value.md5);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("Could not write detection cache '%s'", filename.c_str());
+	delete out;
+}
+
 GameList AdvancedMetaEngine::detectGames(const Common::FSList &fslist) const {
 	ADGameDescList matches;
 	GameList detectedGames;
@@ -167,6 +354,10 @@ GameList AdvancedMetaEngine::detectGames(const Common::FSList &fslist) const {
 	return detectedGames;
 }
 
+void AdvancedMetaEngine::saveDetectionCache() {
+	DetectionMD5Cache::instance().save();
+}
+
 const ExtraGuiOptions AdvancedMetaEngine::getExtraGuiOptions(const Common::String &target) const {
 	if (!_extraGuiOptions)
 		return ExtraGuiOptions();
@@ -403,11 +594,15 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 				if (allFiles.contains(fname)) {
 					debug(3, "+ %s", fname.c_str());
 
+					const Common::FSNode &node = allFiles[fname];
 					Common::File testFile;
 
-					if (testFile.open(allFiles[fname])) {
+					if (DetectionMD5Cache::instance().lookup(node, _md5Bytes, tmp.size, tmp.md5)) {
+						debug(3, "> '%s' found in detection cache", fname.c_str());
+					} else if (testFile.open(node)) {
 						tmp.size = (int32)testFile.size();
 						tmp.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+						DetectionMD5Cache::instance().store(node, _md5Bytes, tmp.size, tmp.md5);
 					} else {
 						tmp.size = -1;
 					}
@@ -250,6 +250,13 @@ public:
 
 	virtual const ExtraGuiOptions getExtraGuiOptions(const Common::String &target) const;
 
+	/**
+	 * Writes the file sizes and MD5 sums computed by detectGames() to the
+	 * detection cache, if any were added. Called once all engines looked
+	 * at a directory, rather than after each of them.
+	 */
+	static void saveDetectionCache();
+
 protected:
 	// To be implemented by subclasses
 	virtual bool createInstance(OSystem *syst, Engine **engine, const ADGameDescription *desc) const = 0;
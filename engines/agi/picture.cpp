@@ -41,6 +41,14 @@ PictureMgr::PictureMgr(AgiBase *agi, GfxMgr *gfx) {
 	_minCommand = 0xf0;
 	_flags = 0;
 	_currentStep = 0;
+
+	memset(_pictureCache, 0, sizeof(_pictureCache));
+	_pictureCacheCounter = 0;
+}
+
+PictureMgr::~PictureMgr() {
+	for (int i = 0; i < kPictureCacheSize; i++)
+		freeCachedPicture(_pictureCache[i]);
 }
 
 void PictureMgr::putVirtPixel(int x, int y) {
@@ -227,17 +235,7 @@ void PictureMgr::absoluteDrawLine() {
 /**************************************************************************
 ** okToFill
 **************************************************************************/
-int PictureMgr::isOkFillHere(int x, int y) {
-	uint8 p;
-
-	x += _xOffset;
-	y += _yOffset;
-
-	if (x < 0 || x >= _width || y < 0 || y >= _height)
-		return false;
-
-	p = _vm->_game.sbuf16c[y * _width + x];
-
+bool PictureMgr::isOkFillPixel(uint8 p) {
 	if (_flags & kPicFTrollMode)
 		return ((p & 0x0f) != 11 && (p & 0x0f) != _scrColor);
 
@@ -257,42 +255,66 @@ void PictureMgr::agiFill(unsigned int x, unsigned int y) {
 	if (!_scrOn && !_priOn)
 		return;
 
+	x += _xOffset;
+	y += _yOffset;
+
+	if (x >= (unsigned int)_width || y >= (unsigned int)_height)
+		return;
+
+	// Whether a pixel may be filled, and what it turns into, only depends
+	// on the pixel itself, so work both out once for every value
+	bool okToFill[256];
+	uint8 filled[256];
+
+	for (int i = 0; i < 256; i++) {
+		okToFill[i] = isOkFillPixel(i);
+		filled[i] = i;
+		if (_priOn)
+			filled[i] = (_priColor << 4) | (filled[i] & 0x0f);
+		if (_scrOn)
+			filled[i] = _scrColor | (filled[i] & 0xf0);
+	}
+
+	uint8 *buffer = _vm->_game.sbuf16c;
+
 	// Push initial pixel on the stack
 	Common::Stack<Common::Point> stack;
-	stack.push(Common::Point(x,y));
+	stack.push(Common::Point(x, y));
 
 	// Exit if stack is empty
 	while (!stack.empty()) {
 		Common::Point p = stack.pop();
-		unsigned int c;
-		int newspanUp, newspanDown;
+		uint8 *row = buffer + p.y * _width;
+		int left, right;
 
-		if (!isOkFillHere(p.x, p.y))
+		if (!okToFill[row[p.x]])
 			continue;
 
-		// Scan for left border
-		for (c = p.x - 1; isOkFillHere(c, p.y); c--)
+		// Fill the whole span around the seed
+		for (left = p.x; left > 0 && okToFill[row[left - 1]]; left--)
 			;
-
-		newspanUp = newspanDown = 1;
-		for (c++; isOkFillHere(c, p.y); c++) {
-			putVirtPixel(c, p.y);
-			if (isOkFillHere(c, p.y - 1)) {
-				if (newspanUp) {
-					stack.push(Common::Point(c,p.y-1));
-					newspanUp = 0;
-				}
-			} else {
-				newspanUp = 1;
-			}
-
-			if (isOkFillHere(c, p.y + 1)) {
-				if (newspanDown) {
-					stack.push(Common::Point(c,p.y+1));
-					newspanDown = 0;
+		for (right = p.x; right < _width - 1 && okToFill[row[right + 1]]; right++)
+			;
+		for (int c = left; c <= right; c++)
+			row[c] = filled[row[c]];
+
+		// Seed each run of fillable pixels above and below the span
+		for (int nextY = p.y - 1; nextY <= p.y + 1; nextY += 2) {
+			if (nextY < 0 || nextY >= _height)
+				continue;
+
+			uint8 *next = buffer + nextY * _width;
+			bool newSpan = true;
+
+			for (int c = left; c <= right; c++) {
+				if (okToFill[next[c]]) {
+					if (newSpan) {
+						stack.push(Common::Point(c, nextY));
+						newSpan = false;
+					}
+				} else {
+					newSpan = true;
 				}
-			} else {
-				newspanDown = 1;
 			}
 		}
 	}
@@ -820,11 +842,26 @@ int PictureMgr::decodePicture(int n, int clr, bool agi256, int pic_width, int pi
 	_width = pic_width;
 	_height = pic_height;
 
-	if (clr && !agi256) // 256 color pictures should always fill the whole screen, so no clearing for them.
-		memset(_vm->_game.sbuf16c, 0x4f, _width * _height); // Clear 16 color AGI screen (Priority 4, color white).
-
 	if (!agi256) {
-		drawPicture(); // Draw 16 color picture.
+		AgiPictureCacheEntry *entry = findCachedPicture(n, clr != 0);
+
+		if (entry) {
+			debugC(8, kDebugLevelResources, "Picture %d taken from cache", n);
+			memcpy(_vm->_game.sbuf16c, entry->after, _width * _height);
+		} else {
+			uint8 *before = NULL;
+
+			// 256 color pictures should always fill the whole screen, so no clearing for them.
+			if (clr) {
+				memset(_vm->_game.sbuf16c, 0x4f, _width * _height); // Clear 16 color AGI screen (Priority 4, color white).
+			} else {
+				before = (uint8 *)malloc(_width * _height);
+				memcpy(before, _vm->_game.sbuf16c, _width * _height);
+			}
+
+			drawPicture(); // Draw 16 color picture.
+			addCachedPicture(n, before);
+		}
 	} else {
 		const uint32 maxFlen = _width * _height;
 		memcpy(_vm->_game.sbuf256c, _data, MIN(_flen, maxFlen)); // Draw 256 color picture.
@@ -890,6 +927,64 @@ int PictureMgr::unloadPicture(int n) {
 	return errOK;
 }
 
+/**
+ * Look for a drawn picture matching the current screen.
+ * Pictures drawn on a cleared screen only need to match the resource,
+ * overlays also have to be drawn over exactly the same screen contents.
+ * @param n      AGI picture resource number
+ * @param clear  whether the screen is cleared before drawing
+ */
+AgiPictureCacheEntry *PictureMgr::findCachedPicture(int n, bool clear) {
+	for (int i = 0; i < kPictureCacheSize; i++) {
+		AgiPictureCacheEntry &entry = _pictureCache[i];
+
+		if (!entry.after || entry.resourceNr != n || (entry.before == NULL) != clear)
+			continue;
+		if (entry.pictureVersion != _pictureVersion || entry.flags != _flags || entry.width != _width || entry.height != _height)
+			continue;
+		if (!clear && memcmp(entry.before, _vm->_game.sbuf16c, _width * _height))
+			continue;
+
+		entry.lastUsed = ++_pictureCacheCounter;
+		return &entry;
+	}
+
+	return NULL;
+}
+
+/**
+ * Remember the picture just drawn, replacing the least recently used one.
+ * @param n       AGI picture resource number
+ * @param before  screen contents before drawing, NULL if it was cleared.
+ *                The cache takes ownership of the buffer.
+ */
+void PictureMgr::addCachedPicture(int n, uint8 *before) {
+	AgiPictureCacheEntry *entry = &_pictureCache[0];
+
+	for (int i = 1; i < kPictureCacheSize && entry->after; i++) {
+		if (!_pictureCache[i].after || _pictureCache[i].lastUsed < entry->lastUsed)
+			entry = &_pictureCache[i];
+	}
+
+	freeCachedPicture(*entry);
+
+	entry->resourceNr = n;
+	entry->pictureVersion = _pictureVersion;
+	entry->flags = _flags;
+	entry->width = _width;
+	entry->height = _height;
+	entry->lastUsed = ++_pictureCacheCounter;
+	entry->before = before;
+	entry->after = (uint8 *)malloc(_width * _height);
+	memcpy(entry->after, _vm->_game.sbuf16c, _width * _height);
+}
+
+void PictureMgr::freeCachedPicture(AgiPictureCacheEntry &entry) {
+	free(entry.before);
+	free(entry.after);
+	entry.before = entry.after = NULL;
+}
+
 void PictureMgr::clear() {
 	memset(_vm->_game.sbuf16c, 0x4f, _width * _height);
 }
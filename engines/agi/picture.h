@@ -53,6 +53,21 @@ enum AgiPictureFlags {
 	kPicFTrollMode = (1 << 5)
 };
 
+/**
+ * A picture resource as drawn by decodePicture(). Drawing a picture again
+ * over the same screen contents gives the same result, so this can be
+ * copied to the screen instead.
+ */
+struct AgiPictureCacheEntry {
+	int resourceNr;
+	AgiPictureVersion pictureVersion;
+	int flags;
+	int width, height;
+	uint32 lastUsed;
+	uint8 *before;		/**< screen the picture was overlaid on, NULL if it was cleared */
+	uint8 *after;		/**< visual and priority screen after drawing the picture */
+};
+
 class AgiBase;
 class GfxMgr;
 
@@ -65,7 +80,7 @@ private:
 	void drawLine(int x1, int y1, int x2, int y2);
 	void dynamicDrawLine();
 	void absoluteDrawLine();
-	int isOkFillHere(int x, int y);
+	bool isOkFillPixel(uint8 p);
 	void agiFill(unsigned int x, unsigned int y);
 	void xCorner(bool skipOtherCoords = false);
 	void yCorner(bool skipOtherCoords = false);
@@ -75,8 +90,13 @@ private:
 
 	uint8 nextByte() { return _data[_foffs++]; }
 
+	AgiPictureCacheEntry *findCachedPicture(int n, bool clear);
+	void addCachedPicture(int n, uint8 *before);
+	void freeCachedPicture(AgiPictureCacheEntry &entry);
+
 public:
 	PictureMgr(AgiBase *agi, GfxMgr *gfx);
+	~PictureMgr();
 
 	void putVirtPixel(int x, int y);
 
@@ -137,6 +157,13 @@ private:
 
 	int _flags;
 	int _currentStep;
+
+	enum {
+		kPictureCacheSize = 32
+	};
+
+	AgiPictureCacheEntry _pictureCache[kPictureCacheSize];
+	uint32 _pictureCacheCounter;
 };
 
 } // End of namespace Agi
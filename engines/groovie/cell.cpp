@@ -22,8 +22,18 @@
 
 #include "groovie/cell.h"
 
+#include "common/algorithm.h"
+
 namespace Groovie {
 
+static int countBits(uint32 bits) {
+	bits = bits - ((bits >> 1) & 0x55555555);
+	bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+	return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+extern const int8 possibleMoves[][9];
+
 CellGame::CellGame() {
 	_startX = _startY = _endX = _endY = 255;
 
@@ -33,6 +43,26 @@ CellGame::CellGame() {
 	_coeff3 = 0;
 
 	_moveCount = 0;
+
+	// The hash only has to be well distributed, not random, so use a fixed
+	// xorshift sequence to keep the search reproducible
+	uint32 seed = 0x9E3779B9;
+	for (int i = 0; i < 49; i++) {
+		for (int j = 0; j < 4; j++) {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			_zobrist[i][j] = seed;
+		}
+	}
+
+	// Mirror countCellsOnTempBoard(), which stops at the first neighbour
+	// numbered 0: cells 1, 7 and 8 never contribute to the sum
+	for (int i = 0; i < 49; i++) {
+		_neighbours[i][0] = _neighbours[i][1] = 0;
+		for (const int8 *str = possibleMoves[i]; *str > 0; str++)
+			_neighbours[i][*str >> 5] |= 1U << (*str & 31);
+	}
 }
 
 byte CellGame::getStartX() {
@@ -179,16 +209,31 @@ const int8 strategy2[][17] = {
 	{ 32, 33, 34, 39, 46, -1 }
 };
 
+void CellGame::toggleCell(BoardKey &key, int8 cell, int8 color) {
+	key.hash ^= _zobrist[cell][color - 1];
+	key.cells[color - 1][cell >> 5] ^= 1U << (cell & 31);
+}
+
+void CellGame::setTempCell(int8 cell, int8 color) {
+	if (_tempBoard[cell] > 0)
+		toggleCell(_tempKey, cell, _tempBoard[cell]);
+	_tempBoard[cell] = color;
+	if (color > 0)
+		toggleCell(_tempKey, cell, color);
+}
+
 void CellGame::copyToTempBoard() {
 	for (int i = 0; i < 53; ++i) {
 		_tempBoard[i] = _board[i];
 	}
+	_tempKey = _boardKey;
 }
 
 void CellGame::copyFromTempBoard() {
 	for (int i = 0; i < 53; ++i) {
 		_board[i] = _tempBoard[i];
 	}
+	_boardKey = _tempKey;
 }
 
 void CellGame::copyToShadowBoard() {
@@ -206,6 +251,7 @@ void CellGame::pushBoard() {
 
 	for (int i = 0; i < 57; ++i)
 		_boardStack[_boardStackPtr + i] = _board[i];
+	_keyStack[_boardStackPtr / 57] = _boardKey;
 	_boardStackPtr += 57;
 }
 
@@ -216,6 +262,7 @@ void CellGame::popBoard() {
 	for (int i = 0; i < 57; ++i) {
 		_board[i] = _boardStack[_boardStackPtr + i];
 	}
+	_boardKey = _keyStack[_boardStackPtr / 57];
 }
 
 void CellGame::pushShadowBoard() {
@@ -270,7 +317,7 @@ void CellGame::takeCells(uint16 whereTo, int8 color) {
 			break;
 		if (_tempBoard[cellN] > 0) {
 			--_tempBoard[_tempBoard[cellN] + 48];
-			_tempBoard[cellN] = color;
+			setTempCell(cellN, color);
 			++_tempBoard[color + 48];
 		}
 	}
@@ -282,7 +329,12 @@ void CellGame::countAllCells() {
 	_board[51] = 0;
 	_board[52] = 0;
 
+	memset(&_boardKey, 0, sizeof(_boardKey));
+
 	for (int i = 0; i < 49; i++) {
+		if (_board[i] > 0)
+			toggleCell(_boardKey, i, _board[i]);
+
 		switch (_board[i]) {
 		case 1:	// CELL_BLUE
 			_board[49]++;
@@ -301,25 +353,19 @@ void CellGame::countAllCells() {
 }
 
 int CellGame::countCellsOnTempBoard(int8 color) {
-	const int8 *str;
+	const BoardKey &key = _tempKey;
+	uint32 empty[2];
 	int res = 0;
-	int i;
 
-	for (i = 0; i < 49; i++)
-		_boardSum[i] = 0;
+	// Sum up the empty neighbours of all cells of the given color
+	for (int i = 0; i < 2; i++)
+		empty[i] = ~(key.cells[0][i] | key.cells[1][i] | key.cells[2][i] | key.cells[3][i]);
 
-	for (i = 0; i < 49; i++) {
-		if (_tempBoard[i] == color) {
-			for (str = possibleMoves[i]; *str > 0; str++) {
-				if (!_tempBoard[*str])
-					++_boardSum[*str];
-			}
-		}
+	for (int i = 0; i < 49; i++) {
+		if (key.cells[color - 1][i >> 5] & (1U << (i & 31)))
+			res += countBits(_neighbours[i][0] & empty[0]) + countBits(_neighbours[i][1] & empty[1]);
 	}
 
-	for (i = 0; i < 49; i++)
-		res += _boardSum[i];
-
 	return res;
 }
 
@@ -465,10 +511,10 @@ bool CellGame::canMoveFunc2(int8 color) {
 
 void CellGame::makeMove(int8 color) {
 	copyToTempBoard();
-	_tempBoard[_board[54]] = color;
+	setTempCell(_board[54], color);
 	++_tempBoard[color + 48];
 	if (_board[55] == 2) {
-		_tempBoard[_board[53]] = 0;
+		setTempCell(_board[53], 0);
 		--_tempBoard[color + 48];
 	}
 	takeCells(_board[54], color);
@@ -549,7 +595,64 @@ void CellGame::chooseBestMove(int8 color) {
 	_endY = _stack_endXY[0] / 7;
 }
 
-int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
+bool CellGame::moveLess(const Move &a, const Move &b) {
+	if (a.weight != b.weight)
+		return a.weight < b.weight;
+	return a.index < b.index;
+}
+
+bool CellGame::nextMove(int type, int8 color) {
+	if (type == 1)
+		return canMoveFunc2(color);
+	else if (type == 2)
+		return canMoveFunc1(color);
+	else
+		return canMoveFunc3(color);
+}
+
+int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int8 alpha, int8 beta) {
+	TransEntry *entry;
+	int8 res;
+
+	pushBoard();
+	copyFromTempBoard();
+
+	// The weight only depends on the cells, the color which moved last, the
+	// remaining depth and _coeff3, so positions reached through different
+	// move orders can share their result
+	entry = &_transTable[_boardKey.hash & (kTransTableSize - 1)];
+	if (entry->depth == depth && entry->color == color2 && entry->coeff3 == _coeff3 &&
+			!memcmp(&entry->key, &_boardKey, sizeof(BoardKey))) {
+		if (entry->bound == kBoundExact ||
+				(entry->bound == kBoundLower && entry->weight >= beta) ||
+				(entry->bound == kBoundUpper && entry->weight < alpha)) {
+			popBoard();
+			return entry->weight;
+		}
+	}
+
+	res = searchBoard(color1, color2, depth, alpha, beta);
+
+	if (!_flag1) {
+		entry->key = _boardKey;
+		entry->color = color2;
+		entry->depth = depth;
+		entry->coeff3 = _coeff3;
+		entry->weight = res;
+		if (res < alpha)
+			entry->bound = kBoundUpper;
+		else if (res >= beta)
+			entry->bound = kBoundLower;
+		else
+			entry->bound = kBoundExact;
+	}
+	popBoard();
+
+	return res;
+}
+
+int8 CellGame::searchBoard(int8 color1, int8 color2, uint16 depth, int8 alpha, int8 beta) {
+	Move moves[kMaxMoves];
 	int8 res;
 	int8 curColor;
 	bool canMove;
@@ -557,16 +660,13 @@ int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWe
 	uint16 i;
 	int8 currBoardWeight;
 	int8 weight;
+	int numMoves;
 
-	pushBoard();
-	copyFromTempBoard();
 	curColor = color2;
 	for (i = 0;; ++i) {
-		if (i >= 4) {
-			res = _coeff3 + 2 * (2 * _board[color1 + 48] - _board[49] - _board[50] - _board[51] - _board[52]);
-			popBoard();
-			return res;
-		}
+		if (i >= 4)
+			return _coeff3 + 2 * (2 * _board[color1 + 48] - _board[49] - _board[50] - _board[51] - _board[52]);
+
 		++curColor;
 		if (curColor > 4)
 			curColor = 1;
@@ -590,73 +690,82 @@ int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWe
 				break;
 		}
 	}
-	if (_flag1) {
-		popBoard();
-		return bestWeight + 1;
-	}
+	if (_flag1)
+		return alpha + 1;
+
+	currBoardWeight = _coeff3 + 2 * (2 * _board[color1 + 48] - _board[49] - _board[50] - _board[51] - _board[52]);
 
 	depth -= 1;
-	if (depth) {
-		makeMove(curColor);
-		if (type == 1) {
-			res = calcBestWeight(color1, curColor, depth, bestWeight);
-		} else {
-			pushShadowBoard();
-			res = calcBestWeight(color1, curColor, depth, bestWeight);
-			popShadowBoard();
-		}
-	} else {
+	if (!depth) {
 		res = getBoardWeight(color1, curColor);
-	}
-
-	if ((res < bestWeight && color1 != curColor) || _flag4) {
-		popBoard();
-		return res;
-	}
-
-	currBoardWeight = _coeff3 + 2 * (2 * _board[color1 + 48] - _board[49] - _board[50] - _board[51] - _board[52]);
-	while (1) {
-		if (type == 1) {
-			canMove = canMoveFunc2(curColor);
-		} else if (type == 2) {
-			canMove = canMoveFunc1(curColor);
-		} else {
-			canMove = canMoveFunc3(curColor);
-		}
+		if ((res < alpha && color1 != curColor) || (res >= beta && color1 == curColor) || _flag4)
+			return res;
 
-		if (!canMove)
-			break;
-		if (_flag1) {
-			popBoard();
-			return bestWeight + 1;
-		}
-		if (_board[55] == 2) {
-			if (getBoardWeight(color1, curColor) == currBoardWeight)
-				continue;
-		}
-		if (!depth) {
+		while (1) {
+			canMove = nextMove(type, curColor);
+			if (!canMove)
+				break;
+			if (_flag1)
+				return alpha + 1;
+			if (_board[55] == 2) {
+				if (getBoardWeight(color1, curColor) == currBoardWeight)
+					continue;
+			}
 			weight = getBoardWeight(color1, curColor);
 			if (type == 1) {
 				if (_board[55] == 2)
 					_board[56] = 16;
 			}
-		} else {
-			makeMove(curColor);
-			if (type != 1) {
-				pushShadowBoard();
-				weight = calcBestWeight(color1, curColor, depth, bestWeight);
-				popShadowBoard();
-			} else {
-				weight = calcBestWeight(color1, curColor, depth, bestWeight);
-			}
+			if ((weight < res && color1 != curColor) || (weight > res && color1 == curColor))
+				res = weight;
+
+			if ((res < alpha && color1 != curColor) || (res >= beta && color1 == curColor) || _flag4)
+				break;
 		}
-		if ((weight < res && color1 != curColor) || (weight > res && color1 == curColor))
+		return res;
+	}
+
+	// Collect all the moves before searching any of them, so that they can
+	// be tried best first. That makes the cutoffs below happen much earlier.
+	numMoves = 0;
+	do {
+		if (_flag1)
+			return alpha + 1;
+		if (numMoves && _board[55] == 2 && getBoardWeight(color1, curColor) == currBoardWeight)
+			continue;
+
+		assert(numMoves < kMaxMoves);
+		moves[numMoves].startXY = _board[53];
+		moves[numMoves].endXY = _board[54];
+		moves[numMoves].pass = _board[55];
+		moves[numMoves].weight = getBoardWeight(color1, curColor);
+		if (color1 == curColor)
+			moves[numMoves].weight = -moves[numMoves].weight;
+		moves[numMoves].index = numMoves;
+		numMoves++;
+	} while (nextMove(type, curColor));
+
+	Common::sort(moves, moves + numMoves, moveLess);
+
+	// Alpha-beta search: the opponent (any other color) is looking for the
+	// lowest weight, color1 for the highest one
+	res = 0;
+	for (int m = 0; m < numMoves; m++) {
+		_board[53] = moves[m].startXY;
+		_board[54] = moves[m].endXY;
+		_board[55] = moves[m].pass;
+		makeMove(curColor);
+		if (color1 == curColor)
+			weight = calcBestWeight(color1, curColor, depth, (m && res > alpha) ? res : alpha, beta);
+		else
+			weight = calcBestWeight(color1, curColor, depth, alpha, (m && res < beta) ? res : beta);
+
+		if (!m || (weight < res && color1 != curColor) || (weight > res && color1 == curColor))
 			res = weight;
 
-		if ((res < bestWeight && color1 != curColor) || _flag4)
+		if ((res < alpha && color1 != curColor) || (res >= beta && color1 == curColor) || _flag4)
 			break;
 	}
-	popBoard();
 
 	return res;
 }
@@ -666,6 +775,8 @@ int16 CellGame::doGame(int8 color, int depth) {
 	int type;
 
 	countAllCells();
+	memset(_transTable, 0, sizeof(_transTable));
+
 	if (_board[color + 48] >= 49 - _board[49] - _board[50] - _board[51] - _board[52]) {
 		resetMove();
 		canMove = canMoveFunc2(color);
@@ -688,10 +799,10 @@ int16 CellGame::doGame(int8 color, int depth) {
 			makeMove(color);
 			_flag4 = false;
 			if (type) {
-				w2 = calcBestWeight(color, color, depth, -127);
+				w2 = calcBestWeight(color, color, depth, -127, 127);
 			} else {
 				pushShadowBoard();
-				w2 = calcBestWeight(color, color, depth, -127);
+				w2 = calcBestWeight(color, color, depth, -127, 127);
 				popShadowBoard();
 			}
 		} else {
@@ -719,10 +830,10 @@ int16 CellGame::doGame(int8 color, int depth) {
 				makeMove(color);
 				_flag4 = false;
 				if (type) {
-					w1 = calcBestWeight(color, color, depth, w2);
+					w1 = calcBestWeight(color, color, depth, w2, 127);
 				} else {
 					pushShadowBoard();
-					w1 = calcBestWeight(color, color, depth, w2);
+					w1 = calcBestWeight(color, color, depth, w2, 127);
 					popShadowBoard();
 				}
 			} else {
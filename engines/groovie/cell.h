@@ -46,6 +46,46 @@ public:
 	int playStauf(byte color, uint16 depth, byte *scriptBoard);
 
 private:
+	enum {
+		kMaxMoves = 49 * 16,
+		kTransTableSize = 1024
+	};
+
+	/**
+	 * Bitboard view of a position: one 49 bit occupancy mask per color,
+	 * plus its Zobrist hash. Kept up to date alongside _board/_tempBoard.
+	 */
+	struct BoardKey {
+		uint32 hash;
+		uint32 cells[4][2];
+	};
+
+	enum Bound {
+		kBoundExact,
+		kBoundLower,
+		kBoundUpper
+	};
+
+	struct TransEntry {
+		BoardKey key;
+		int8 color;
+		int8 depth;
+		int8 coeff3;
+		int8 bound;
+		int8 weight;
+	};
+
+	struct Move {
+		int8 startXY;
+		int8 endXY;
+		int8 pass;
+		int8 weight;
+		int16 index;
+	};
+
+	static bool moveLess(const Move &a, const Move &b);
+	void toggleCell(BoardKey &key, int8 cell, int8 color);
+	void setTempCell(int8 cell, int8 color);
 	void copyToTempBoard();
 	void copyFromTempBoard();
 	void copyToShadowBoard();
@@ -59,13 +99,15 @@ private:
 	bool canMoveFunc1(int8 color);
 	bool canMoveFunc2(int8 color);
 	bool canMoveFunc3(int8 color);
+	bool nextMove(int type, int8 color);
 	void takeCells(uint16 whereTo, int8 color);
 	void countAllCells();
 	int countCellsOnTempBoard(int8 color);
 	void makeMove(int8 color);
 	int getBoardWeight(int8 color1, int8 color2);
 	void chooseBestMove(int8 color);
-	int8 calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
+	int8 calcBestWeight(int8 color1, int8 color2, uint16 depth, int8 alpha, int8 beta);
+	int8 searchBoard(int8 color1, int8 color2, uint16 depth, int8 alpha, int8 beta);
 	int16 doGame(int8 color, int depth);
 	int16 calcMove(int8 color, uint16 depth);
 
@@ -80,7 +122,13 @@ private:
 	int8 _boardStack[570];
 	int _boardStackPtr;
 
-	int8 _boardSum[58];
+	BoardKey _boardKey;
+	BoardKey _tempKey;
+	BoardKey _keyStack[10];
+
+	uint32 _zobrist[49][4];
+	uint32 _neighbours[49][2];
+	TransEntry _transTable[kTransTableSize];
 
 	int8 _stack_startXY[128];
 	int8 _stack_endXY[128];
@@ -1461,17 +1461,6 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 		&Screen::drawShapeSkipScaleDownwind
 	};
 
-	static const DsLineFunc dsLineFunc[] = {
-		&Screen::drawShapeProcessLineNoScaleUpwind,
-		&Screen::drawShapeProcessLineNoScaleDownwind,
-		&Screen::drawShapeProcessLineNoScaleUpwind,
-		&Screen::drawShapeProcessLineNoScaleDownwind,
-		&Screen::drawShapeProcessLineScaleUpwind,
-		&Screen::drawShapeProcessLineScaleDownwind,
-		&Screen::drawShapeProcessLineScaleUpwind,
-		&Screen::drawShapeProcessLineScaleDownwind
-	};
-
 	static const DsPlotFunc dsPlotFunc[] = {
 		&Screen::drawShapePlotType0,		// used by Kyra 1 + 2
 		&Screen::drawShapePlotType1,		// used by Kyra 3
@@ -1511,13 +1500,12 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 	const int drawFunc = flags & 0x0f;
 	_dsProcessMargin = dsMarginFunc[drawFunc];
 	_dsScaleSkip = dsSkipFunc[drawFunc];
-	_dsProcessLine = dsLineFunc[drawFunc];
 
 	const int ppc = (flags >> 8) & 0x3F;
+	const int ppc3 = (flags & 0x800) ? (((flags >> 8) & 0xF7) & 0x3F) : ppc;
 	_dsPlot = dsPlotFunc[ppc];
-	DsPlotFunc dsPlot2 = dsPlotFunc[ppc], dsPlot3 = dsPlotFunc[ppc];
-	if (flags & 0x800)
-		dsPlot3 = dsPlotFunc[((flags >> 8) & 0xF7) & 0x3F];
+	DsPlotFunc dsPlot2 = dsPlotFunc[ppc], dsPlot3 = dsPlotFunc[ppc3];
+	DsLineFunc dsLine2 = getShapeLineFunc(drawFunc, ppc), dsLine3 = getShapeLineFunc(drawFunc, ppc3);
 
 	if (!_dsPlot || !dsPlot2 || !dsPlot3) {
 		if (!dsPlot2)
@@ -1706,6 +1694,7 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 					if (flags & 0x800)
 						normalPlot = (curY > _maskMinY && curY < _maskMaxY);
 					_dsPlot = normalPlot ? dsPlot2 : dsPlot3;
+					_dsProcessLine = normalPlot ? dsLine2 : dsLine3;
 					(this->*_dsProcessLine)(d, src, cnt, scaleState);
 				}
 				cnt += _dsOffscreenRight;
@@ -1920,6 +1909,153 @@ void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, i
 	cnt = -1;
 }
 
+Screen::DsLineFunc Screen::getShapeLineFunc(int drawFunc, int plotType) const {
+	static const DsLineFunc dsLineFunc[] = {
+		&Screen::drawShapeProcessLineNoScaleUpwind,
+		&Screen::drawShapeProcessLineNoScaleDownwind,
+		&Screen::drawShapeProcessLineNoScaleUpwind,
+		&Screen::drawShapeProcessLineNoScaleDownwind,
+		&Screen::drawShapeProcessLineScaleUpwind,
+		&Screen::drawShapeProcessLineScaleDownwind,
+		&Screen::drawShapeProcessLineScaleUpwind,
+		&Screen::drawShapeProcessLineScaleDownwind
+	};
+
+	static const DsLineFunc dsLineFuncCopy[] = {
+		&Screen::drawShapeProcessLineNoScaleUpwindRuns<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineNoScaleDownwindRuns<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineNoScaleUpwindRuns<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineNoScaleDownwindRuns<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineScaleUpwindPlot<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineScaleDownwindPlot<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineScaleUpwindPlot<kDsPlotCopy>,
+		&Screen::drawShapeProcessLineScaleDownwindPlot<kDsPlotCopy>
+	};
+
+	static const DsLineFunc dsLineFuncRemap[] = {
+		&Screen::drawShapeProcessLineNoScaleUpwindRuns<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineNoScaleDownwindRuns<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineNoScaleUpwindRuns<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineNoScaleDownwindRuns<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineScaleUpwindPlot<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineScaleDownwindPlot<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineScaleUpwindPlot<kDsPlotRemap>,
+		&Screen::drawShapeProcessLineScaleDownwindPlot<kDsPlotRemap>
+	};
+
+	if (plotType == kDsPlotCopy)
+		return dsLineFuncCopy[drawFunc];
+	else if (plotType == kDsPlotRemap)
+		return dsLineFuncRemap[drawFunc];
+	return dsLineFunc[drawFunc];
+}
+
+template<int plotType>
+void Screen::drawShapeProcessLineNoScaleUpwindRuns(uint8 *&dst, const uint8 *&src, int &cnt, int16) {
+	do {
+		int run = 0;
+		while (run < cnt && src[run])
+			++run;
+
+		if (run) {
+			if (plotType == kDsPlotCopy) {
+				memcpy(dst, src, run);
+			} else {
+				for (int i = 0; i < run; ++i)
+					drawShapePlotPixel<plotType>(dst + i, src[i]);
+			}
+			dst += run;
+			src += run;
+			cnt -= run;
+		} else {
+			uint8 c = src[1];
+			src += 2;
+			dst += c;
+			cnt -= c;
+		}
+	} while (cnt > 0);
+}
+
+template<int plotType>
+void Screen::drawShapeProcessLineNoScaleDownwindRuns(uint8 *&dst, const uint8 *&src, int &cnt, int16) {
+	do {
+		int run = 0;
+		while (run < cnt && src[run])
+			++run;
+
+		if (run) {
+			for (int i = 0; i < run; ++i)
+				drawShapePlotPixel<plotType>(dst - i, src[i]);
+			dst -= run;
+			src += run;
+			cnt -= run;
+		} else {
+			uint8 c = src[1];
+			src += 2;
+			dst -= c;
+			cnt -= c;
+		}
+	} while (cnt > 0);
+}
+
+template<int plotType>
+void Screen::drawShapeProcessLineScaleUpwindPlot(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState) {
+	int c = 0;
+
+	do {
+		if ((scaleState & 0x8000) || !(scaleState & 0xFF00)) {
+			c = *src++;
+			_dsTmpWidth--;
+			if (c) {
+				scaleState += _dsScaleW;
+			} else {
+				_dsTmpWidth++;
+				c = *src++;
+				_dsTmpWidth -= c;
+				int r = c * _dsScaleW + scaleState;
+				dst += (r >> 8);
+				cnt -= (r >> 8);
+				scaleState = r & 0xff;
+			}
+		} else if (scaleState) {
+			drawShapePlotPixel<plotType>(dst++, c);
+			scaleState -= 0x100;
+			cnt--;
+		}
+	} while (cnt > 0);
+
+	cnt = -1;
+}
+
+template<int plotType>
+void Screen::drawShapeProcessLineScaleDownwindPlot(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState) {
+	int c = 0;
+
+	do {
+		if ((scaleState & 0x8000) || !(scaleState & 0xFF00)) {
+			c = *src++;
+			_dsTmpWidth--;
+			if (c) {
+				scaleState += _dsScaleW;
+			} else {
+				_dsTmpWidth++;
+				c = *src++;
+				_dsTmpWidth -= c;
+				int r = c * _dsScaleW + scaleState;
+				dst -= (r >> 8);
+				cnt -= (r >> 8);
+				scaleState = r & 0xff;
+			}
+		} else {
+			drawShapePlotPixel<plotType>(dst--, c);
+			scaleState -= 0x100;
+			cnt--;
+		}
+	} while (cnt > 0);
+
+	cnt = -1;
+}
+
 void Screen::drawShapePlotType0(uint8 *dst, uint8 cmd) {
 	*dst = cmd;
 }
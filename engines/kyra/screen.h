@@ -637,6 +637,23 @@ protected:
 	void drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
 	void drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
 
+	// Versions of the line functions for the most common plotting types,
+	// which draw the pixels themselves instead of calling _dsPlot for each
+	// one. The unscaled ones copy whole runs of opaque pixels at once.
+	enum {
+		kDsPlotCopy = 0,
+		kDsPlotRemap = 4
+	};
+
+	template<int plotType> void drawShapePlotPixel(uint8 *dst, uint8 cmd) {
+		*dst = (plotType == kDsPlotRemap) ? _dsTable2[cmd] : cmd;
+	}
+
+	template<int plotType> void drawShapeProcessLineNoScaleUpwindRuns(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
+	template<int plotType> void drawShapeProcessLineNoScaleDownwindRuns(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
+	template<int plotType> void drawShapeProcessLineScaleUpwindPlot(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
+	template<int plotType> void drawShapeProcessLineScaleDownwindPlot(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
+
 	void drawShapePlotType0(uint8 *dst, uint8 cmd);
 	void drawShapePlotType1(uint8 *dst, uint8 cmd);
 	void drawShapePlotType3_7(uint8 *dst, uint8 cmd);
@@ -661,6 +678,9 @@ protected:
 	typedef void (Screen::*DsLineFunc)(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState);
 	typedef void (Screen::*DsPlotFunc)(uint8 *dst, uint8 cmd);
 
+	/** The line function for the given draw function and plotting type. */
+	DsLineFunc getShapeLineFunc(int drawFunc, int plotType) const;
+
 	DsMarginSkipFunc _dsProcessMargin;
 	DsMarginSkipFunc _dsScaleSkip;
 	DsLineFunc _dsProcessLine;
@@ -71,6 +71,10 @@ MohawkEngine_Myst::MohawkEngine_Myst(OSystem *syst, const MohawkGameDescription
 	// original, including bugs, missing bits etc. :)
 	_tweaksEnabled = true;
 
+	// Memory (in KB) the resource cache may use
+	if (ConfMan.hasKey("cache_size"))
+		_cache.setMaxSize(ConfMan.getInt("cache_size") * 1024);
+
 	_currentCursor = 0;
 	_mainCursor = kDefaultMystCursor;
 	_showResourceRects = false;
@@ -138,7 +142,14 @@ Common::SeekableReadStream *MohawkEngine_Myst::getResource(uint32 tag, uint16 id
 	for (uint32 i = 0; i < _mhk.size(); i++)
 		if (_mhk[i]->hasResource(tag, id)) {
 			ret = _mhk[i]->getResource(tag, id);
-			_cache.add(tag, id, ret);
+
+			// Read from the cached copy, instead of making another one
+			Common::SeekableReadStream *cached = _cache.add(tag, id, ret);
+			if (cached) {
+				delete ret;
+				ret = cached;
+			}
+
 			return ret;
 		}
 
@@ -159,14 +170,14 @@ void MohawkEngine_Myst::cachePreload(uint32 tag, uint16 id) {
 
 			// We've found where the real MSND data is, so go get that
 			tempData = _mhk[i]->getResource(tag, msndId);
-			_cache.add(tag, id, tempData);
+			delete _cache.add(tag, id, tempData);
 			delete tempData;
 			return;
 		}
 
 		if (_mhk[i]->hasResource(tag, id)) {
 			Common::SeekableReadStream *tempData = _mhk[i]->getResource(tag, id);
-			_cache.add(tag, id, tempData);
+			delete _cache.add(tag, id, tempData);
 			delete tempData;
 			return;
 		}
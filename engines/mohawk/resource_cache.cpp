@@ -21,13 +21,34 @@
  */
 
 #include "common/debug.h"
+#include "common/memstream.h"
 #include "mohawk/myst.h"
 #include "mohawk/resource_cache.h"
 
 namespace Mohawk {
 
+namespace {
+
+struct ArrayDeleter {
+	void operator()(byte *ptr) { delete[] ptr; }
+};
+
+/** A stream on cached data, keeping it alive while it is read. */
+class CachedDataStream : public Common::MemoryReadStream {
+public:
+	CachedDataStream(const Common::SharedPtr<byte> &data, uint32 size) :
+		Common::MemoryReadStream(data.get(), size), _data(data) {}
+
+private:
+	Common::SharedPtr<byte> _data;
+};
+
+} // End of anonymous namespace
+
 ResourceCache::ResourceCache() {
 	enabled = true;
+	_size = 0;
+	_maxSize = kDefaultMaxSize;
 }
 
 ResourceCache::~ResourceCache() {
@@ -40,25 +61,41 @@ void ResourceCache::clear() {
 
 	debugC(kDebugCache, "Clearing Cache...");
 
-	for (uint32 i = 0; i < _store.size(); i++)
-		delete _store[i].data;
-
 	_store.clear();
+	_index.clear();
+	_size = 0;
 }
 
-void ResourceCache::add(uint32 tag, uint16 id, Common::SeekableReadStream *data) {
+Common::SeekableReadStream *ResourceCache::add(uint32 tag, uint16 id, Common::SeekableReadStream *data) {
 	if (!enabled)
-		return;
+		return NULL;
 
 	debugC(kDebugCache, "Adding item %d - tag 0x%04X id %d", _store.size(), tag, id);
 
+	ObjectMap::iterator existing = _index.find(Key(tag, id));
+	if (existing != _index.end())
+		remove(existing->_value);
+
 	DataObject current;
 	current.tag = tag;
 	current.id = id;
+	current.size = data->size();
+
+	// Make room for the new data first
+	shrink(_maxSize > current.size ? _maxSize - current.size : 0);
+
+	byte *buffer = new byte[current.size];
 	uint32 dataCurPos = data->pos();
-	current.data = data->readStream(data->size());
+	data->seek(0);
+	data->read(buffer, current.size);
 	data->seek(dataCurPos);
-	_store.push_back(current);
+	current.data = Buffer(buffer, ArrayDeleter());
+
+	_store.push_front(current);
+	_index[Key(tag, id)] = _store.begin();
+	_size += current.size;
+
+	return createStream(current);
 }
 
 // Returns NULL if not found
@@ -68,18 +105,45 @@ Common::SeekableReadStream *ResourceCache::search(uint32 tag, uint16 id) {
 
 	debugC(kDebugCache, "Searching for tag 0x%04X id %d", tag, id);
 
-	for (uint32 i = 0; i < _store.size(); i++) {
-		if (tag == _store[i].tag && id == _store[i].id) {
-			debugC(kDebugCache, "Found cached tag 0x%04X id %u", tag, id);
-			uint32 dataCurPos  = _store[i].data->pos();
-			Common::SeekableReadStream *ret = _store[i].data->readStream(_store[i].data->size());
-			_store[i].data->seek(dataCurPos);
-			return ret;
-		}
+	ObjectMap::iterator it = _index.find(Key(tag, id));
+	if (it == _index.end()) {
+		debugC(kDebugCache, "tag 0x%04X id %d not found", tag, id);
+		return NULL;
+	}
+
+	debugC(kDebugCache, "Found cached tag 0x%04X id %u", tag, id);
+
+	// Move it to the front of the list
+	if (it->_value != _store.begin()) {
+		_store.push_front(*it->_value);
+		_store.erase(it->_value);
+		it->_value = _store.begin();
 	}
 
-	debugC(kDebugCache, "tag 0x%04X id %d not found", tag, id);
-	return NULL;
+	return createStream(*it->_value);
+}
+
+void ResourceCache::setMaxSize(uint32 size) {
+	_maxSize = size;
+	shrink(_maxSize);
+}
+
+Common::SeekableReadStream *ResourceCache::createStream(const DataObject &object) {
+	return new CachedDataStream(object.data, object.size);
+}
+
+void ResourceCache::remove(ObjectList::iterator it) {
+	_size -= it->size;
+	_index.erase(Key(it->tag, it->id));
+	_store.erase(it);
+}
+
+void ResourceCache::shrink(uint32 size) {
+	while (_size > size && !_store.empty()) {
+		ObjectList::iterator last = _store.reverse_begin();
+		debugC(kDebugCache, "Dropping tag 0x%04X id %d", last->tag, last->id);
+		remove(last);
+	}
 }
 
 } // End of namespace Mohawk
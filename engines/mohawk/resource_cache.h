@@ -23,32 +23,88 @@
 #ifndef RESOURCE_CACHE_H
 #define RESOURCE_CACHE_H
 
-#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/ptr.h"
 #include "common/stream.h"
 
 namespace Mohawk {
 
+/**
+ * Keeps resources in memory, so that they don't have to be read again.
+ *
+ * The data of each resource is shared by all streams handed out for it,
+ * and only freed once the last of them is deleted, so data evicted from
+ * the cache stays valid for the streams still reading it.
+ */
 class ResourceCache {
 public:
+	enum {
+		/** Default number of bytes the cached data may take up */
+		kDefaultMaxSize = 16 * 1024 * 1024
+	};
+
 	ResourceCache();
 	~ResourceCache();
 
 	bool enabled;
 
 	void clear();
-	void add(uint32 tag, uint16 id, Common::SeekableReadStream *data);
+
+	/**
+	 * Read a resource into the cache.
+	 * @return a stream on the cached data, or NULL if the cache is disabled.
+	 *         The position of data is not changed.
+	 */
+	Common::SeekableReadStream *add(uint32 tag, uint16 id, Common::SeekableReadStream *data);
 
 	// Returns NULL if not found
 	Common::SeekableReadStream *search(uint32 tag, uint16 id);
 
+	/**
+	 * Set the number of bytes the cached data may take up. Beyond that,
+	 * the least recently used resources are dropped.
+	 */
+	void setMaxSize(uint32 size);
+
 private:
+	typedef Common::SharedPtr<byte> Buffer;
+
 	struct DataObject {
 		uint32 tag;
 		uint16 id;
-		Common::SeekableReadStream *data;
+		Buffer data;
+		uint32 size;
 	};
 
-	Common::Array<DataObject> _store;
+	// Most recently used first
+	typedef Common::List<DataObject> ObjectList;
+
+	struct Key {
+		uint32 tag;
+		uint16 id;
+
+		Key(uint32 t, uint16 i) : tag(t), id(i) {}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const { return key.tag ^ (key.id * 2654435761U); }
+	};
+
+	struct KeyEqual {
+		bool operator()(const Key &a, const Key &b) const { return a.tag == b.tag && a.id == b.id; }
+	};
+
+	typedef Common::HashMap<Key, ObjectList::iterator, KeyHash, KeyEqual> ObjectMap;
+
+	ObjectList _store;
+	ObjectMap _index;
+	uint32 _size;
+	uint32 _maxSize;
+
+	static Common::SeekableReadStream *createStream(const DataObject &object);
+	void remove(ObjectList::iterator it);
+	void shrink(uint32 size);
 };
 
 } // End of namespace Mohawk
@@ -97,6 +97,7 @@ IsoMap::IsoMap(SagaEngine *vm) : _vm(vm) {
 	_viewScroll.x = (128 - 8) * 16;
 	_viewScroll.y = (128 - 8) * 16 - 64;
 	_viewDiff = 1;
+	_layerCounter = 0;
 }
 
 void IsoMap::loadImages(const ByteArray &resourceData) {
@@ -137,6 +138,8 @@ void IsoMap::loadImages(const ByteArray &resourceData) {
 	for (i = 0; i < _tilesTable.size(); i++) {
 		_tilesTable[i].tilePointer = _tileData.getBuffer() + tempOffsets[i] - offsetDiff;
 	}
+
+	invalidateLayers();
 }
 
 void IsoMap::loadPlatforms(const ByteArray &resourceData) {
@@ -166,6 +169,7 @@ void IsoMap::loadPlatforms(const ByteArray &resourceData) {
 		}
 	}
 
+	invalidateLayers();
 }
 
 void IsoMap::loadMap(const ByteArray &resourceData) {
@@ -185,6 +189,7 @@ void IsoMap::loadMap(const ByteArray &resourceData) {
 		}
 	}
 
+	invalidateLayers();
 }
 
 void IsoMap::loadMetaTiles(const ByteArray &resourceData) {
@@ -207,6 +212,8 @@ void IsoMap::loadMetaTiles(const ByteArray &resourceData) {
 			metaTileData->stack[j] = readS.readSint16();
 		}
 	}
+
+	invalidateLayers();
 }
 
 void IsoMap::loadMulti(const ByteArray &resourceData) {
@@ -248,6 +255,8 @@ void IsoMap::loadMulti(const ByteArray &resourceData) {
 	for (i = 0; i < _multiTableData.size(); i++) {
 		_multiTableData[i] = readS.readSint16();
 	}
+
+	invalidateLayers();
 }
 
 void IsoMap::clear() {
@@ -257,6 +266,7 @@ void IsoMap::clear() {
 	_multiTable.clear();
 	_tileData.clear();
 	_multiTableData.clear();
+	invalidateLayers();
 }
 
 void IsoMap::adjustScroll(bool jump) {
@@ -361,8 +371,73 @@ int16 IsoMap::findMulti(int16 tileIndex, int16 absU, int16 absV, int16 absH) {
 
 void IsoMap::draw() {
 	_tileClip = _vm->_scene->getSceneClip();
+
+	// Nothing but the scroll position and the door states changes what is
+	// drawn here, so reuse an earlier result whenever possible. Sprites and
+	// the tiles in front of them are drawn on top of this afterwards.
+	if (drawLayer())
+		return;
+
 	_vm->_gfx->drawRect(_tileClip, 0);
 	drawTiles(NULL);
+	storeLayer();
+}
+
+bool IsoMap::drawLayer() {
+	IsoMapLayer *layer;
+	int width = _tileClip.width();
+	int pitch = _vm->_gfx->getBackBufferPitch();
+	byte *dst;
+	int i, y;
+
+	for (i = 0; i < SAGA_ISOMAP_LAYERS; i++) {
+		layer = &_layers[i];
+		if (!layer->pixels.empty() && layer->viewScroll == _viewScroll && layer->clip == _tileClip)
+			break;
+	}
+
+	if (i == SAGA_ISOMAP_LAYERS)
+		return false;
+
+	layer->lastUsed = ++_layerCounter;
+
+	dst = _vm->_gfx->getBackBufferPixels() + _tileClip.top * pitch + _tileClip.left;
+	for (y = 0; y < _tileClip.height(); y++, dst += pitch)
+		memcpy(dst, layer->pixels.getBuffer() + y * width, width);
+
+	_vm->_render->addDirtyRect(_tileClip);
+	return true;
+}
+
+void IsoMap::storeLayer() {
+	IsoMapLayer *layer = &_layers[0];
+	int width = _tileClip.width();
+	int pitch = _vm->_gfx->getBackBufferPitch();
+	const byte *src;
+	int i, y;
+
+	if (_tileClip.isEmpty())
+		return;
+
+	// Replace an unused or the least recently used layer
+	for (i = 1; i < SAGA_ISOMAP_LAYERS && !layer->pixels.empty(); i++) {
+		if (_layers[i].pixels.empty() || _layers[i].lastUsed < layer->lastUsed)
+			layer = &_layers[i];
+	}
+
+	layer->viewScroll = _viewScroll;
+	layer->clip = _tileClip;
+	layer->lastUsed = ++_layerCounter;
+	layer->pixels.resize(width * _tileClip.height());
+
+	src = _vm->_gfx->getBackBufferPixels() + _tileClip.top * pitch + _tileClip.left;
+	for (y = 0; y < _tileClip.height(); y++, src += pitch)
+		memcpy(layer->pixels.getBuffer() + y * width, src, width);
+}
+
+void IsoMap::invalidateLayers() {
+	for (int i = 0; i < SAGA_ISOMAP_LAYERS; i++)
+		_layers[i].pixels.clear();
 }
 
 void IsoMap::setMapPosition(int x, int y) {
@@ -1602,7 +1677,10 @@ void IsoMap::setTileDoorState(int doorNumber, int doorState) {
 	}
 
 	multiTileEntryData = &_multiTable[doorNumber];
-	multiTileEntryData->currentState = doorState;
+	if (multiTileEntryData->currentState != doorState) {
+		multiTileEntryData->currentState = doorState;
+		invalidateLayers();
+	}
 }
 
 bool IsoMap::nextTileTarget(ActorData* actor) {
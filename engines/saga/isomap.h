@@ -72,6 +72,8 @@ namespace Saga {
 #define SAGA_DIAG_HARD_COST					10
 #define SAGA_MAX_PATH_DIRECTIONS			256
 
+#define SAGA_ISOMAP_LAYERS 4
+
 enum TerrainTypes {
 	kTerrNone	= 0,
 	kTerrPath	= 1,
@@ -147,6 +149,14 @@ struct MultiTileEntryData {
 
 
 
+// The static part of the map as drawn by IsoMap::draw() for one scroll position
+struct IsoMapLayer {
+	Point viewScroll;
+	Rect clip;
+	uint32 lastUsed;
+	ByteArray pixels;
+};
+
 class IsoMap {
 public:
 	IsoMap(SagaEngine *vm);
@@ -178,6 +188,9 @@ public:
 
 private:
 	void drawTiles(const Location *location);
+	bool drawLayer();
+	void storeLayer();
+	void invalidateLayers();
 	void drawMetaTile(uint16 metaTileIndex, const Point &point, int16 absU, int16 absV);
 	void drawSpriteMetaTile(uint16 metaTileIndex, const Point &point, Location &location, int16 absU, int16 absV);
 	void drawPlatform(uint16 platformIndex, const Point &point, int16 absU, int16 absV, int16 absH);
@@ -279,6 +292,9 @@ private:
 	Point _viewScroll;
 	Rect _tileClip;
 
+	IsoMapLayer _layers[SAGA_ISOMAP_LAYERS];
+	uint32 _layerCounter;
+
 	SagaEngine *_vm;
 };
 
@@ -80,6 +80,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	DVar_Register("sleeptime_factor",	&g_debug_sleeptime_factor, DVAR_INT, 0);
 	DVar_Register("gc_interval",		&engine->_gamestate->scriptGCInterval, DVAR_INT, 0);
+	DVar_Register("gc_incremental",		&engine->_gamestate->gcIncremental, DVAR_BOOL, 0);
 	DVar_Register("simulated_key",		&g_debug_simulated_key, DVAR_INT, 0);
 	DVar_Register("track_mouse_clicks",	&g_debug_track_mouse_clicks, DVAR_BOOL, 0);
 	DVar_Register("script_abort_flag",	&_engine->_gamestate->abortScriptProcessing, DVAR_INT, 0);
@@ -146,6 +147,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	DCmd_Register("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	DCmd_Register("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	DCmd_Register("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	DCmd_Register("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	DCmd_Register("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -201,6 +203,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	DCmd_Register("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	DCmd_Register("script_decode_bench",	WRAP_METHOD(Console, cmdScriptDecodeBench));
 	DCmd_Register("vm_varlist",			WRAP_METHOD(Console, cmdVMVarlist));
 	DCmd_Register("vmvarlist",			WRAP_METHOD(Console, cmdVMVarlist));				// alias
 	DCmd_Register("vl",					WRAP_METHOD(Console, cmdVMVarlist));				// alias
@@ -308,6 +311,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("---------\n");
 	DebugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	DebugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	DebugPrintf("gc_incremental: Spreads freeing unreachable memory over the following kernel calls\n");
 	DebugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	DebugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
 	DebugPrintf("weak_validations: Turns some validation errors into warnings\n");
@@ -380,6 +384,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	DebugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	DebugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	DebugPrintf(" gc_stats - Shows how long garbage collections took\n");
 	DebugPrintf("\n");
 	DebugPrintf("Music/SFX:\n");
 	DebugPrintf(" songlib - Shows the song library\n");
@@ -421,6 +426,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("\n");
 	DebugPrintf("VM:\n");
 	DebugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	DebugPrintf(" script_decode_bench - Times parsing the instructions of the loaded scripts\n");
 	DebugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	DebugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	DebugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -2160,6 +2166,24 @@ bool Console::cmdIsSample(int argc, const char **argv) {
 bool Console::cmdGCInvoke(int argc, const char **argv) {
 	DebugPrintf("Performing garbage collection...\n");
 	run_gc(_engine->_gamestate);
+	gc_step(_engine->_gamestate, _engine->_gamestate->_segMan->getUnreachableCount());
+	return true;
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	const GCStats &stats = _engine->_gamestate->gcStats;
+
+	DebugPrintf("Garbage collections: %u, %s\n", stats.runs,
+			_engine->_gamestate->gcIncremental ? "incremental" : "not incremental");
+	if (stats.runs) {
+		DebugPrintf("Pause: last %u ms, longest %u ms, average %u ms\n",
+				stats.lastPause, stats.maxPause, stats.totalPause / stats.runs);
+		DebugPrintf("Last collection: %u reachable addresses, %u unreachable entries\n",
+				stats.lastReachable, stats.lastUnreachable);
+	}
+	DebugPrintf("Incremental steps: %u, longest %u ms, %u entries still queued\n",
+			stats.steps, stats.maxStepPause, _engine->_gamestate->_segMan->getUnreachableCount());
+
 	return true;
 }
 
@@ -2637,6 +2661,101 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdScriptDecodeBench(int argc, const char **argv) {
+	const int passes = (argc > 1) ? atoi(argv[1]) : 100;
+	if (passes <= 0) {
+		DebugPrintf("Times parsing every instruction of the methods of all loaded scripts,\n");
+		DebugPrintf("once each time and once through the instructions kept by the scripts.\n");
+		DebugPrintf("Usage: %s [<passes>]\n", argv[0]);
+		return true;
+	}
+
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+
+	// Collect the start of every instruction of every method, in the same
+	// way find_callk walks through them
+	Common::Array<reg_t> code;
+	uint cached = 0;
+
+	for (uint seg = 1; seg < heap.size(); seg++) {
+		if (!heap[seg] || heap[seg]->getType() != SEG_TYPE_SCRIPT)
+			continue;
+
+		Script *script = (Script *)heap[seg];
+		cached += script->getInstructionCount();
+
+		const ObjMap &objects = script->getObjectMap();
+		for (ObjMap::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+			const Object *obj = &it->_value;
+
+			for (uint16 i = 0; i < obj->getMethodCount(); i++) {
+				uint16 offset = obj->getFunction(i).offset;
+				uint16 maxJmpOffset = 0;
+
+				while (offset < script->getBufSize()) {
+					code.push_back(make_reg(seg, offset));
+
+					int16 opparams[4];
+					byte extOpcode;
+					offset += readPMachineInstruction(script->getBuf(offset), extOpcode, opparams);
+					const byte opcode = extOpcode >> 1;
+
+					if (opcode == op_bt || opcode == op_bnt || opcode == op_jmp) {
+						uint16 curJmpOffset = offset + (uint16)opparams[0];
+						if (curJmpOffset > maxJmpOffset && curJmpOffset < script->getScriptSize())
+							maxJmpOffset = curJmpOffset;
+					}
+
+					if (opcode == op_ret && offset >= maxJmpOffset)
+						break;
+				}
+			}
+		}
+	}
+
+	if (code.empty()) {
+		DebugPrintf("No scripts loaded\n");
+		return true;
+	}
+
+	DebugPrintf("%d instructions in the loaded methods, %d of them executed so far\n", code.size(), cached);
+
+	// Sum up the results, so that the compiler can not skip any work
+	uint32 checksum = 0;
+
+	uint32 startTime = g_system->getMillis();
+	for (int pass = 0; pass < passes; pass++) {
+		for (uint i = 0; i < code.size(); i++) {
+			const Script *script = (const Script *)heap[code[i].segment];
+			int16 opparams[4];
+			byte extOpcode;
+			checksum += readPMachineInstruction(script->getBuf(code[i].offset), extOpcode, opparams);
+			checksum += extOpcode + opparams[0];
+		}
+	}
+	const uint32 parseTime = g_system->getMillis() - startTime;
+
+	startTime = g_system->getMillis();
+	for (int pass = 0; pass < passes; pass++) {
+		for (uint i = 0; i < code.size(); i++) {
+			Script *script = (Script *)heap[code[i].segment];
+			const PMachineInstruction &instruction = script->getInstruction(code[i].offset);
+			checksum -= instruction.size;
+			checksum -= instruction.extOpcode + instruction.opparams[0];
+		}
+	}
+	const uint32 cacheTime = g_system->getMillis() - startTime;
+
+	const double count = (double)code.size() * passes;
+	DebugPrintf("Parsing every time: %d ms, %.1f ns per instruction\n", parseTime, parseTime * 1e6 / count);
+	DebugPrintf("Kept instructions:  %d ms, %.1f ns per instruction\n", cacheTime, cacheTime * 1e6 / count);
+	if (checksum)
+		DebugPrintf("Kept instructions differ from the script code!\n");
+
+	return true;
+}
+
 bool Console::cmdBacktrace(int argc, const char **argv) {
 	DebugPrintf("Call stack (current base: 0x%x):\n", _engine->_gamestate->executionStackBase);
 	Common::List<ExecStack>::const_iterator iter;
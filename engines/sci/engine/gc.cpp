@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 namespace Sci {
@@ -160,11 +161,33 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
+static bool isTableSegment(SegmentType type) {
+	switch (type) {
+	case SEG_TYPE_CLONES:
+	case SEG_TYPE_LISTS:
+	case SEG_TYPE_NODES:
+	case SEG_TYPE_HUNK:
+#ifdef ENABLE_SCI32
+	case SEG_TYPE_ARRAY:
+	case SEG_TYPE_STRING:
+#endif
+		return true;
+	default:
+		return false;
+	}
+}
+
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getMillis();
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
+
+	// Finish off the previous collection first, everything it queued is
+	// still unreachable and would be found again anyway
+	segMan->freeUnreachable(segMan->getUnreachableCount());
+	uint unreachable = 0;
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
@@ -189,11 +212,19 @@ void run_gc(EngineState *s) {
 
 			// Get a list of all deallocatable objects in this segment,
 			// then free any which are not referenced from somewhere.
+			// Table entries can be freed later on, as nothing can
+			// reach them anymore and their slots stay taken until then.
+			const bool queue = s->gcIncremental && isTableSegment(mobj->getType());
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
+					unreachable++;
+					if (queue) {
+						segMan->queueUnreachable(addr);
+						continue;
+					}
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
@@ -205,8 +236,21 @@ void run_gc(EngineState *s) {
 		}
 	}
 
+	GCStats &stats = s->gcStats;
+	stats.lastReachable = activeRefs->size();
+	stats.lastUnreachable = unreachable;
+
 	delete activeRefs;
 
+	const uint32 pause = g_system->getMillis() - startTime;
+	stats.runs++;
+	stats.lastPause = pause;
+	stats.maxPause = MAX(stats.maxPause, pause);
+	stats.totalPause += pause;
+
+	debugC(kDebugLevelGC, "[GC] %u entries unreachable, %u queued, took %u ms",
+			unreachable, segMan->getUnreachableCount(), pause);
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -216,4 +260,14 @@ void run_gc(EngineState *s) {
 #endif
 }
 
+void gc_step(EngineState *s, uint maxEntries) {
+	const uint32 startTime = g_system->getMillis();
+
+	s->_segMan->freeUnreachable(maxEntries);
+
+	GCStats &stats = s->gcStats;
+	stats.steps++;
+	stats.maxStepPause = MAX(stats.maxStepPause, g_system->getMillis() - startTime);
+}
+
 } // End of namespace Sci
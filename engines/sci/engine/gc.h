@@ -50,11 +50,23 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs garbage collection on the current system state.
+ *
+ * Finding the reachable memory has to be done in one go, as the VM writes
+ * references without telling anyone. With s->gcIncremental set, the
+ * unreachable entries of the table segments are only queued afterwards,
+ * and freed bit by bit by gc_step() over the following kernel calls.
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
 
+/**
+ * Frees some of the entries queued by an incremental garbage collection
+ * @param s          The state in which we should gc
+ * @param maxEntries The maximum number of entries to free
+ */
+void gc_step(EngineState *s, uint maxEntries);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
@@ -28,6 +28,7 @@
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
 
+#include "common/array.h"
 #include "common/debug-channels.h"
 #include "common/list.h"
 #include "common/system.h"
@@ -94,10 +95,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Index in the cached visibility graph, -1 for single-vertex polygons
+	int visIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		visIndex = -1;
 	}
 };
 
@@ -214,6 +219,19 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+// Visibility of a pair of vertices in the cached visibility graph
+enum {
+	kVisUnknown = 0,
+	kVisBlocked = 1,
+	kVisVisible = 2
+};
+
+// Polygon edge starting at a vertex, with its bounding box
+struct Edge {
+	Vertex *vertex;
+	int16 minX, minY, maxX, maxY;
+};
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -228,6 +246,13 @@ struct PathfindingState {
 	// Total number of vertices
 	int vertices;
 
+	// All polygon edges, for the intersection tests
+	Common::Array<Edge> edges;
+
+	// Visibility graph of the vertices with a visIndex, or NULL
+	byte *visibility;
+	int visVertices;
+
 	// Point to prepend and append to final path
 	Common::Point *_prependPoint;
 	Common::Point *_appendPoint;
@@ -242,6 +267,8 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		visibility = NULL;
+		visVertices = 0;
 	}
 
 	~PathfindingState() {
@@ -637,6 +664,52 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether two vertices can see each other.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the first vertex
+ * @param vertex		the second vertex
+ * @return true if the line between the vertices doesn't intersect any polygon
+ */
+static bool is_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// An edge can only intersect the line, or have its vertex on it, if
+	// their bounding boxes overlap. This does not hold for lines of length
+	// 0, which between() treats as horizontal ones of any length.
+	const bool useBox = (vertex_cur->v != vertex->v);
+	const int16 minX = MIN(vertex_cur->v.x, vertex->v.x);
+	const int16 maxX = MAX(vertex_cur->v.x, vertex->v.x);
+	const int16 minY = MIN(vertex_cur->v.y, vertex->v.y);
+	const int16 maxY = MAX(vertex_cur->v.y, vertex->v.y);
+
+	// Check for intersecting edges
+	for (uint i = 0; i < s->edges.size(); i++) {
+		const Edge &e = s->edges[i];
+
+		if (useBox && (e.maxX < minX || e.minX > maxX || e.maxY < minY || e.minY > maxY))
+			continue;
+
+		Vertex *edge = e.vertex;
+
+		if (between(vertex_cur->v, vertex->v, edge->v)) {
+			// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+			if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+				return false;
+
+			// This edge won't properly intersect, so we continue
+			continue;
+		}
+
+		if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+			return false;
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -649,30 +722,26 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		if (vertex == vertex_cur)
 			continue;
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+		bool visible;
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
+		if (s->visibility && vertex_cur->visIndex >= 0 && vertex->visIndex >= 0) {
+			// Visibility is symmetric, so fill in both directions at once
+			byte &vis = s->visibility[vertex_cur->visIndex * s->visVertices + vertex->visIndex];
+
+			if (vis == kVisUnknown) {
+				vis = is_visible(s, vertex_cur, vertex) ? kVisVisible : kVisBlocked;
+				s->visibility[vertex->visIndex * s->visVertices + vertex_cur->visIndex] = vis;
 			}
+
+			visible = (vis == kVisVisible);
+		} else {
+			visible = is_visible(s, vertex_cur, vertex);
 		}
 
-		if (j == s->vertices)
+		if (visible)
 			visVerts->push_front(vertex);
 	}
 
@@ -1163,6 +1232,48 @@ static void change_polygons_opt_0(PathfindingState *s) {
 	}
 }
 
+/**
+ * Attaches the cached visibility graph to the pathfinding state, starting a
+ * new one if the polygons have changed since the last call. The visibility
+ * between two vertices of polygons with edges only depends on these
+ * polygons, so the graph covers those. The start and end points are often
+ * merged in as single-vertex polygons, their visibility is always computed
+ * anew.
+ * Parameters: (EngineState *) s: The game state
+ *             (PathfindingState *) pf_s: The pathfinding state
+ */
+static void attach_visibility_graph(EngineState *s, PathfindingState *pf_s) {
+	AvoidPathCache &cache = s->_avoidPathCache;
+	Common::Array<int16> key;
+	int visVertices = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		Polygon *polygon = *it;
+		Vertex *vertex;
+
+		if (!VERTEX_HAS_EDGES(polygon->vertices.first()))
+			continue;
+
+		key.push_back(polygon->vertices.size());
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->visIndex = visVertices++;
+			key.push_back(vertex->v.x);
+			key.push_back(vertex->v.y);
+		}
+	}
+
+	if (key != cache.polygons) {
+		debugC(kDebugLevelAvoidPath, "AvoidPath: Polygons changed, new visibility graph for %d vertices", visVertices);
+		cache.polygons = key;
+		cache.visibility.clear();
+		cache.visibility.resize(visVertices * visVertices);
+	}
+
+	pf_s->visibility = cache.visibility.begin();
+	pf_s->visVertices = visVertices;
+}
+
 /**
  * Converts the SCI input data for pathfinding
  * Parameters: (EngineState *) s: The game state
@@ -1277,6 +1388,24 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 
 	pf_s->vertices = count;
 
+	// Collect the polygon edges
+	for (int i = 0; i < count; i++) {
+		Vertex *vertex = pf_s->vertex_index[i];
+
+		if (VERTEX_HAS_EDGES(vertex)) {
+			const Common::Point &next = CLIST_NEXT(vertex)->v;
+			Edge edge;
+			edge.vertex = vertex;
+			edge.minX = MIN(vertex->v.x, next.x);
+			edge.maxX = MAX(vertex->v.x, next.x);
+			edge.minY = MIN(vertex->v.y, next.y);
+			edge.maxY = MAX(vertex->v.y, next.y);
+			pf_s->edges.push_back(edge);
+		}
+	}
+
+	attach_visibility_graph(s, pf_s);
+
 	return pf_s;
 }
 
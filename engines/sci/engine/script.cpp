@@ -61,6 +61,27 @@ void Script::freeScript() {
 	_bufSize = 0;
 
 	_objects.clear();
+
+	_instructionIndex.clear();
+	_instructions.clear();
+}
+
+const PMachineInstruction &Script::parseInstruction(uint16 offset) {
+	// Only keep the instructions as long as the index can refer to them,
+	// which is more than any script actually has
+	PMachineInstruction *instruction = &_uncachedInstruction;
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_bufSize);
+
+	if (offset < _instructionIndex.size() && _instructions.size() < 0xFFFF) {
+		_instructions.push_back(PMachineInstruction());
+		_instructionIndex[offset] = _instructions.size();
+		instruction = &_instructions.back();
+	}
+
+	instruction->size = readPMachineInstruction(_buf + offset, instruction->extOpcode, instruction->opparams);
+	return *instruction;
 }
 
 void Script::init(int script_nr, ResourceManager *resMan) {
@@ -140,6 +161,9 @@ void Script::load(ResourceManager *resMan) {
 	_buf = (byte *)malloc(_bufSize);
 	assert(_buf);
 
+	_instructionIndex.clear();
+	_instructions.clear();
+
 	assert(_bufSize >= script->size);
 	memcpy(_buf, script->data, script->size);
 
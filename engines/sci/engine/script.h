@@ -74,6 +74,14 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * For each offset into the buffer, 1 + the index of the instruction
+	 * there in _instructions, or 0 if it has not been parsed yet.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions; /**< Instructions parsed so far */
+	PMachineInstruction _uncachedInstruction; /**< Used once _instructions is full */
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -98,6 +106,22 @@ public:
 	void init(int script_nr, ResourceManager *resMan);
 	void load(ResourceManager *resMan);
 
+	/**
+	 * Returns the instruction at the given offset. It is only parsed by
+	 * readPMachineInstruction() the first time it is asked for, the code of
+	 * a script does not change once it is loaded.
+	 * The returned reference is only valid until the next call, callers
+	 * which run any script code in the meantime have to copy it.
+	 */
+	const PMachineInstruction &getInstruction(uint16 offset) {
+		if (offset < _instructionIndex.size() && _instructionIndex[offset])
+			return _instructions[_instructionIndex[offset] - 1];
+		return parseInstruction(offset);
+	}
+
+	/** Number of instructions parsed and kept by getInstruction(). */
+	uint getInstructionCount() const { return _instructions.size(); }
+
 	void matchSignatureAndPatch(uint16 scriptNr, byte *scriptData, const uint32 scriptSize);
 	int32 findSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize);
 	void applyPatch(const uint16 *patch, byte *scriptData, const uint32 scriptSize, int32 signatureOffset);
@@ -252,6 +276,8 @@ public:
 	int getCodeBlockOffset() { return READ_SCI11ENDIAN_UINT32(_buf); }
 
 private:
+	const PMachineInstruction &parseInstruction(uint16 offset);
+
 	/**
 	 * Processes a relocation block within a SCI0-SCI2.1 script
 	 *  This function is idempotent, but it must only be called after all
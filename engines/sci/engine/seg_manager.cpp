@@ -31,6 +31,8 @@ namespace Sci {
 SegManager::SegManager(ResourceManager *resMan) {
 	_heap.push_back(0);
 
+	_unreachableCount = 0;
+
 	_clonesSegId = 0;
 	_listsSegId = 0;
 	_nodesSegId = 0;
@@ -59,6 +61,9 @@ void SegManager::resetSegMan() {
 
 	_heap.clear();
 
+	_unreachable.clear();
+	_unreachableCount = 0;
+
 	// And reinitialize
 	_heap.push_back(0);
 
@@ -159,6 +164,63 @@ void SegManager::deallocate(SegmentId seg) {
 	_heap[seg] = NULL;
 }
 
+void SegManager::queueUnreachable(reg_t addr) {
+	// The garbage collector queues the entries segment by segment, so
+	// usually the list to add to is the last one
+	if (_unreachable.empty() || _unreachable.back().segment != addr.segment) {
+		UnreachableList list;
+		list.segment = addr.segment;
+		_unreachable.push_back(list);
+	}
+
+	_unreachable.back().offsets.push_back(addr.offset);
+	_unreachableCount++;
+}
+
+void SegManager::freeQueuedEntry(SegmentId seg, uint16 offset) {
+	// The entry may have been freed explicitly in the meantime
+	SegmentObj *mobj = (seg < _heap.size()) ? _heap[seg] : 0;
+	if (mobj && mobj->isValidOffset(offset)) {
+		debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", seg, offset);
+		mobj->freeAtAddress(this, make_reg(seg, offset));
+	}
+}
+
+uint SegManager::freeUnreachable(uint maxEntries) {
+	uint freed = 0;
+
+	while (freed < maxEntries && !_unreachable.empty()) {
+		UnreachableList &list = _unreachable.back();
+
+		while (freed < maxEntries && !list.offsets.empty()) {
+			freeQueuedEntry(list.segment, list.offsets.back());
+			list.offsets.pop_back();
+			freed++;
+		}
+
+		if (list.offsets.empty())
+			_unreachable.pop_back();
+	}
+
+	_unreachableCount -= freed;
+	return freed;
+}
+
+void SegManager::flushUnreachable(SegmentId seg) {
+	for (uint i = 0; i < _unreachable.size(); i++) {
+		if (_unreachable[i].segment != seg)
+			continue;
+
+		const Common::Array<uint16> &offsets = _unreachable[i].offsets;
+		for (uint j = 0; j < offsets.size(); j++)
+			freeQueuedEntry(seg, offsets[j]);
+
+		_unreachableCount -= offsets.size();
+		_unreachable.remove_at(i);
+		return;
+	}
+}
+
 bool SegManager::isHeapObject(reg_t pos) const {
 	const Object *obj = getObject(pos);
 	if (obj == NULL || (obj && obj->isFreed()))
@@ -869,6 +931,8 @@ void SegManager::freeArray(reg_t addr) {
 	if (_heap[addr.segment]->getType() != SEG_TYPE_ARRAY)
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	flushUnreachable(addr.segment);
+
 	ArrayTable *arrayTable = (ArrayTable *)_heap[addr.segment];
 
 	if (!arrayTable->isValidEntry(addr.offset))
@@ -909,6 +973,8 @@ void SegManager::freeString(reg_t addr) {
 	if (_heap[addr.segment]->getType() != SEG_TYPE_STRING)
 		error("freeString: Attempt to use non-string %04x:%04x as string", PRINT_REG(addr));
 
+	flushUnreachable(addr.segment);
+
 	StringTable *stringTable = (StringTable *)_heap[addr.segment];
 
 	if (!stringTable->isValidEntry(addr.offset))
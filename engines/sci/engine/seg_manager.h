@@ -441,7 +441,43 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Queues an unreachable entry of a table segment (clones, lists, nodes,
+	 * hunks, arrays or strings), so that the garbage collector can spread
+	 * freeing it over the following kernel calls with freeUnreachable().
+	 *
+	 * Queued entries stay allocated until then, so their slots can not be
+	 * handed out again in the meantime.
+	 */
+	void queueUnreachable(reg_t addr);
+
+	/**
+	 * Frees up to maxEntries entries queued by queueUnreachable().
+	 * @return the number of entries taken from the queue
+	 */
+	uint freeUnreachable(uint maxEntries);
+
+	/** Returns the number of entries queued by queueUnreachable(). */
+	uint getUnreachableCount() const { return _unreachableCount; }
+
 private:
+	/** Entries of one segment queued by queueUnreachable(). */
+	struct UnreachableList {
+		SegmentId segment;
+		Common::Array<uint16> offsets;
+	};
+
+	/**
+	 * Frees the entries of a segment queued by queueUnreachable(). Called
+	 * before a script frees an entry there explicitly, after which its
+	 * slot could be reused.
+	 */
+	void flushUnreachable(SegmentId seg);
+	void freeQueuedEntry(SegmentId seg, uint16 offset);
+
+	Common::Array<UnreachableList> _unreachable;
+	uint _unreachableCount;
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
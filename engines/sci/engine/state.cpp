@@ -70,6 +70,9 @@ static const uint16 s_halfWidthSJISMap[256] = {
 EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan), _dirseeker() {
 
+	// Set up once, so that changing it in the debugger survives restoring
+	gcIncremental = true;
+
 	reset(false);
 }
 
@@ -98,6 +101,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	gcStats.reset();
 
 	_throttleCounter = 0;
 	_throttleLastTime = 0;
@@ -131,6 +131,33 @@ struct VideoState {
 	}
 };
 
+/** Timings of the garbage collector, in milliseconds, for the debugger. */
+struct GCStats {
+	uint32 runs;			///< Number of collections so far
+	uint32 lastPause;		///< Time the last collection stopped the VM for
+	uint32 maxPause;		///< Longest time a collection stopped the VM for
+	uint32 totalPause;		///< Time spent in all collections
+	uint32 steps;			///< Number of incremental steps freeing queued entries
+	uint32 maxStepPause;	///< Longest time an incremental step took
+	uint lastReachable;		///< Number of reachable addresses found by the last collection
+	uint lastUnreachable;	///< Number of unreachable entries found by the last collection
+
+	void reset() {
+		runs = lastPause = maxPause = totalPause = steps = maxStepPause = 0;
+		lastReachable = lastUnreachable = 0;
+	}
+};
+
+/**
+ * Visibility graph of the obstacle polygons of the last kAvoidPath call.
+ * Rooms query the same polygons over and over again, with only the start
+ * and end points changing, so it is kept until the polygons change.
+ */
+struct AvoidPathCache {
+	Common::Array<int16> polygons;	///< Vertex count and coordinates of each polygon
+	Common::Array<byte> visibility;	///< Visibility of each pair of vertices, 0 if not known yet
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -216,9 +243,13 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	bool gcIncremental; /**< Free unreachable table entries over the following kernel calls, instead of all at once */
+	GCStats gcStats;
 
 	MessageState *_msgState;
 
+	AvoidPathCache _avoidPathCache;
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -628,9 +628,12 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.offset, scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.offset += readPMachineInstruction(scr->getBuf() + s->xs->addr.pc.offset, extOpcode, opparams);
+		// Get opcode. The instruction has to be copied, as kernel calls and
+		// sends can run other code of the same script, or even unload it.
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.offset);
+		s->xs->addr.pc.offset += instruction.size;
+		const byte extOpcode = instruction.extOpcode;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -856,6 +859,8 @@ void run_vm(EngineState *s) {
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
 				run_gc(s);
+			} else if (s->_segMan->getUnreachableCount()) {
+				gc_step(s, GC_STEP_ENTRIES);
 			}
 
 			// Call kernel function
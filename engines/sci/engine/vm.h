@@ -139,6 +139,11 @@ enum {
 	GC_INTERVAL = 0x8000
 };
 
+/** Number of entries an incremental gc frees per kernel call */
+enum {
+	GC_STEP_ENTRIES = 32
+};
+
 enum sci_opcodes {
 	op_bnot     = 0x00,	// 000
 	op_add      = 0x01,	// 001
@@ -364,6 +369,17 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * A PMachine instruction, as parsed by readPMachineInstruction(). Scripts
+ * keep the instructions they execute in this form (see
+ * Script::getInstruction()), so that each one is only parsed once.
+ */
+struct PMachineInstruction {
+	byte extOpcode;		///< "extended" opcode of the instruction
+	uint16 size;		///< length of the instruction in bytes
+	int16 opparams[4];	///< parameters of the instruction
+};
+
 } // End of namespace Sci
 
 #endif // SCI_ENGINE_VM_H
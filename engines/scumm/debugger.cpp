@@ -78,6 +78,8 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("script",    WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
+	DCmd_Register("opcodes",   WRAP_METHOD(ScummDebugger, Cmd_Opcodes));
+	DCmd_Register("prefetch",  WRAP_METHOD(ScummDebugger, Cmd_Prefetch));
 	DCmd_Register("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
 
 	if (_vm->_game.id == GID_LOOM)
@@ -330,6 +332,75 @@ bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_Opcodes(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "on")) {
+		_vm->enableOpcodeProfiling(true);
+		DebugPrintf("Counting executed opcodes\n");
+		return true;
+	}
+	if (argc == 2 && !strcmp(argv[1], "off")) {
+		_vm->enableOpcodeProfiling(false);
+		DebugPrintf("Stopped counting executed opcodes\n");
+		return true;
+	}
+
+	const uint32 *counts = _vm->getOpcodeCounts();
+	if (!counts || (argc == 2 && !Common::isDigit(argv[1][0]))) {
+		DebugPrintf("Syntax: opcodes on|off|<count>\n");
+		DebugPrintf("Shows the <count> most often executed opcodes (default: 20)\n");
+		return true;
+	}
+
+	int show = (argc == 2) ? atoi(argv[1]) : 20;
+
+	uint32 total = 0;
+	for (int i = 0; i < 256; i++)
+		total += counts[i];
+
+	DebugPrintf("%u opcodes executed\n", total);
+
+	// Repeatedly pick the most executed opcode not shown yet
+	bool shown[256];
+	memset(shown, 0, sizeof(shown));
+
+	for (; show > 0; show--) {
+		int best = -1;
+		for (int i = 0; i < 256; i++) {
+			if (!shown[i] && counts[i] && (best < 0 || counts[i] > counts[best]))
+				best = i;
+		}
+		if (best < 0)
+			break;
+
+		shown[best] = true;
+		DebugPrintf("  %02x %-28s %10u %5.1f%%\n", best, _vm->getOpcodeName(best),
+				counts[best], counts[best] * 100.0 / total);
+	}
+
+	return true;
+}
+
+static void printPrefetchStats(GUI::Debugger *debugger, const char *what, const ScummEngine::PrefetchStats &stats) {
+	debugger->DebugPrintf("%s room %d: %u of %u resources prefetched, %u hits, %u misses\n",
+		what, stats.room, stats.loaded, stats.queued, stats.hits, stats.misses);
+	debugger->DebugPrintf("  %u bytes read ahead, %u bytes on demand\n", stats.prefetchBytes, stats.demandBytes);
+}
+
+bool ScummDebugger::Cmd_Prefetch(int argc, const char **argv) {
+	if (argc == 2 && (!strcmp(argv[1], "on") || !strcmp(argv[1], "off"))) {
+		_vm->enablePrefetch(!strcmp(argv[1], "on"));
+	} else if (argc != 1) {
+		DebugPrintf("Syntax: prefetch [on|off]\n");
+		DebugPrintf("Shows how well loading the resources of a room ahead of their use works\n");
+		return true;
+	}
+
+	DebugPrintf("Prefetching is %s, %u resources pending\n", _vm->isPrefetchEnabled() ? "on" : "off", _vm->getPrefetchPending());
+	printPrefetchStats(this, "Current", _vm->getPrefetchStats(false));
+	printPrefetchStats(this, "Previous", _vm->getPrefetchStats(true));
+	return true;
+}
+
 bool ScummDebugger::Cmd_Actor(int argc, const char **argv) {
 	Actor *a;
 	int actnum;
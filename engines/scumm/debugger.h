@@ -52,6 +52,8 @@ private:
 	bool Cmd_Object(int argc, const char **argv);
 	bool Cmd_Script(int argc, const char **argv);
 	bool Cmd_PrintScript(int argc, const char **argv);
+	bool Cmd_Opcodes(int argc, const char **argv);
+	bool Cmd_Prefetch(int argc, const char **argv);
 	bool Cmd_ImportRes(int argc, const char **argv);
 
 	bool Cmd_PrintDraft(int argc, const char **argv);
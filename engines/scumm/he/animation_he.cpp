@@ -36,9 +36,15 @@ namespace Scumm {
 
 MoviePlayer::MoviePlayer(ScummEngine_v90he *vm, Audio::Mixer *mixer) : _vm(vm) {
 #ifdef USE_BINK
-	if (_vm->_game.heversion >= 100 && (_vm->_game.features & GF_16BIT_COLOR))
-		_video = new Video::BinkDecoder();
-	else
+	_bink = 0;
+
+	if (_vm->_game.heversion >= 100 && (_vm->_game.features & GF_16BIT_COLOR)) {
+		_video = _bink = new Video::BinkDecoder();
+
+		// Frames are decoded while the engine waits for the next tick, so
+		// that expensive ones don't hold up the game
+		_bink->setDecodeAhead(kDecodeAheadFrames);
+	} else
 #endif
 		_video = new Video::SmackerDecoder(mixer);
 
@@ -168,6 +174,15 @@ void MoviePlayer::handleNextFrame() {
 		_video->close();
 }
 
+bool MoviePlayer::decodeAhead() {
+#ifdef USE_BINK
+	if (_bink)
+		return _bink->decodeAhead();
+#endif
+
+	return false;
+}
+
 void MoviePlayer::close() {
 	_video->close();
 }
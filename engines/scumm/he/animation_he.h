@@ -27,6 +27,7 @@
 
 namespace Video {
 	class VideoDecoder;
+	class BinkDecoder;
 }
 
 namespace Scumm {
@@ -35,6 +36,11 @@ class ScummEngine_v90he;
 
 class MoviePlayer {
 public:
+	enum {
+		/** Number of video frames decoded ahead of time, if supported */
+		kDecodeAheadFrames = 4
+	};
+
 	MoviePlayer(ScummEngine_v90he *vm, Audio::Mixer *mixer);
 	~MoviePlayer();
 
@@ -43,6 +49,7 @@ public:
 
 	void copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint pitch);
 	void handleNextFrame();
+	bool decodeAhead();
 
 	void close();
 	int getWidth() const;
@@ -54,6 +61,9 @@ private:
 	ScummEngine_v90he *_vm;
 
 	Video::VideoDecoder *_video;
+#ifdef USE_BINK
+	Video::BinkDecoder *_bink; ///< _video, if it is a Bink decoder
+#endif
 
 	char baseName[40];
 	uint32 _flags;
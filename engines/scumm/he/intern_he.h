@@ -452,6 +452,7 @@ protected:
 	virtual void scummLoop_handleDrawing();
 	virtual void runBootscript();
 
+	virtual bool decodeVideoAhead();
 	virtual void processInput();
 	virtual void clearClickedStatus();
 
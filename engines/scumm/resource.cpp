@@ -44,10 +44,10 @@ namespace Scumm {
 
 enum {
 	RF_LOCK = 0x80,
-	RF_USAGE = 0x7F,
-	RF_USAGE_MAX = RF_USAGE,
+	RF_USAGE_MAX = 0x7F,
 
 	RS_MODIFIED = 0x10,
+	RS_PREFETCHED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -535,12 +535,14 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 	if (num >= 8000)
 		error("Too many %s resources (%d) in directory", nameOfResType(type), num);
 
-	_types[type]._mode = mode;
-	_types[type]._tag = tag;
-
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++)
+		nukeResource(type, idx);
 	_types[type].clear();
+
+	_types[type]._mode = mode;
+	_types[type]._tag = tag;
 	_types[type].resize(num);
 
 /*
@@ -614,6 +616,11 @@ void ScummEngine::ensureResourceLoaded(ResType type, ResId idx) {
 
 	loadResource(type, idx);
 
+	if (type == rtScript || type == rtCostume || type == rtSound) {
+		_prefetchStats.misses++;
+		_prefetchStats.demandBytes += _res->_types[type][idx]._size;
+	}
+
 	if (_game.version == 5 && type == rtRoom && (int)idx == _roomResource)
 		VAR(VAR_ROOM_FLAG) = 1;
 }
@@ -700,6 +707,85 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 	return 1;
 }
 
+void ScummEngine::queueRoomPrefetch(int room) {
+	_lastPrefetchStats = _prefetchStats;
+	_prefetchStats.reset(room);
+	_prefetchQueue.clear();
+	_prefetchNext = 0;
+
+	// Only the plain SCUMM formats are handled: prefetchResource() has to
+	// check the header of each resource before loadResource() gets to see
+	// it, so that a stale index entry cannot error() out.
+	if (!_prefetchEnabled || room == 0 || _game.version < 5 || _game.heversion != 0 ||
+	    (_game.features & (GF_SMALL_HEADER | GF_OLD_BUNDLE)))
+		return;
+
+	// Scripts and costumes first, they are small and usually needed right
+	// away, sounds may well be big
+	static const ResType types[] = { rtScript, rtCostume, rtSound };
+
+	for (int i = 0; i < ARRAYSIZE(types); i++) {
+		const ResourceManager::ResTypeData &resTypeData = _res->_types[types[i]];
+		for (ResId idx = 1; idx < resTypeData.size(); idx++) {
+			const ResourceManager::Resource &res = resTypeData[idx];
+			if (res._roomno == room && res._roomoffs != RES_INVALID_OFFSET && !res._address) {
+				PrefetchEntry entry;
+				entry.type = types[i];
+				entry.idx = idx;
+				_prefetchQueue.push_back(entry);
+			}
+		}
+	}
+
+	_prefetchStats.queued = _prefetchQueue.size();
+}
+
+bool ScummEngine::prefetchResource() {
+	while (_prefetchNext < _prefetchQueue.size()) {
+		const PrefetchEntry entry = _prefetchQueue[_prefetchNext++];
+		ResourceManager::Resource &res = _res->_types[entry.type][entry.idx];
+
+		// Loaded on demand in the meantime, or we are in another room now
+		if (res._address || res._roomno != _roomResource)
+			continue;
+
+		openRoom(_roomResource);
+		_fileHandle->seek(res._roomoffs + _fileOffset, SEEK_SET);
+		const uint32 tag = _fileHandle->readUint32BE();
+		const uint32 size = _fileHandle->readUint32BE();
+		const uint32 soundTag = _fileHandle->readUint32BE();
+
+		if (_fileHandle->err() || _fileHandle->eos())
+			continue;
+
+		if (entry.type == rtSound) {
+			// Only the formats readSoundResource() takes without any
+			// further files or a matching music driver
+			if (soundTag != MKTAG('S','O','U',' ') && soundTag != MKTAG('M','I','D','I') && soundTag != MKTAG('i','M','U','S'))
+				continue;
+		} else if (tag != _res->_types[entry.type]._tag) {
+			continue;
+		}
+
+		// Never push out anything that is in memory already, the current
+		// room may well hold pointers to it
+		if (!_res->hasHeapRoom(size)) {
+			_prefetchNext = _prefetchQueue.size();
+			break;
+		}
+
+		if (!loadResource(entry.type, entry.idx) || !res._address)
+			continue;
+
+		res.setPrefetched();
+		_prefetchStats.loaded++;
+		_prefetchStats.prefetchBytes += res._size;
+		return true;
+	}
+
+	return false;
+}
+
 int ScummEngine::getResourceRoomNr(ResType type, ResId idx) {
 	if (type == rtRoom && _game.heversion < 70)
 		return idx;
@@ -746,6 +832,11 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return NULL;
 	}
 
+	if (_res->_types[type][idx].isPrefetched()) {
+		_res->_types[type][idx].clearPrefetched();
+		_prefetchStats.hits++;
+	}
+
 	_res->setResourceCounter(type, idx, 1);
 
 	debugC(DEBUG_RESOURCE, "getResourceAddress(%s,%d) == %p", nameOfResType(type), idx, ptr);
@@ -776,29 +867,73 @@ void ResourceManager::increaseExpireCounter() {
 	}
 }
 
-void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
-		}
-	}
+void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
+	Resource &res = _types[type][idx];
+	const uint32 age = (counter > 1) ? counter - 1 : 0;
+	res._lastUsed = _epoch - age;
+
+	if (!res._address || !isExpirable(type))
+		return;
+
+	// Keep the list ordered by age. Nearly all calls come from
+	// getResourceAddress(), with a counter of 1, for a resource which
+	// is already at the end of the list.
+	if (_lruTail.type == type && _lruTail.idx == idx && age == 0)
+		return;
+
+	unlinkResource(type, idx);
+
+	ResourceLink after = _lruTail;
+	while (after.type != rtInvalid && _epoch - getLinkedResource(after)._lastUsed < age)
+		after = getLinkedResource(after)._lruPrev;
+
+	linkResource(type, idx, after);
 }
 
-void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
-	_types[type][idx].setResourceCounter(counter);
+byte ResourceManager::getResourceCounter(ResType type, ResId idx) const {
+	const Resource &res = _types[type][idx];
+	if (!res._address)
+		return 0;
+	return MIN<uint32>(_epoch - res._lastUsed + 1, RF_USAGE_MAX);
 }
 
-void ResourceManager::Resource::setResourceCounter(byte counter) {
-	_flags &= RF_LOCK;	// Clear lower 7 bits, preserve the lock bit.
-	_flags |= counter;	// Update the usage counter
+void ResourceManager::linkResource(ResType type, ResId idx, ResourceLink after) {
+	Resource &res = _types[type][idx];
+	ResourceLink self;
+	self.type = type;
+	self.idx = idx;
+
+	res._lruPrev = after;
+	if (after.type == rtInvalid) {
+		res._lruNext = _lruHead;
+		_lruHead = self;
+	} else {
+		Resource &prev = getLinkedResource(after);
+		res._lruNext = prev._lruNext;
+		prev._lruNext = self;
+	}
+
+	if (res._lruNext.type == rtInvalid)
+		_lruTail = self;
+	else
+		getLinkedResource(res._lruNext)._lruPrev = self;
 }
 
-byte ResourceManager::Resource::getResourceCounter() const {
-	return _flags & RF_USAGE;
+void ResourceManager::unlinkResource(ResType type, ResId idx) {
+	Resource &res = _types[type][idx];
+
+	if (res._lruPrev.type == rtInvalid)
+		_lruHead = res._lruNext;
+	else
+		getLinkedResource(res._lruPrev)._lruNext = res._lruNext;
+
+	if (res._lruNext.type == rtInvalid)
+		_lruTail = res._lruPrev;
+	else
+		getLinkedResource(res._lruNext)._lruPrev = res._lruPrev;
+
+	res._lruPrev.type = rtInvalid;
+	res._lruNext.type = rtInvalid;
 }
 
 /* 2 bytes safety area to make "precaching" of bytes in the gdi drawer easier */
@@ -833,6 +968,8 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
+	if (isExpirable(type))
+		linkResource(type, idx, _lruTail);
 	setResourceCounter(type, idx, 1);
 	return ptr;
 }
@@ -844,6 +981,9 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_lastUsed = 0;
+	_lruPrev.type = _lruNext.type = rtInvalid;
+	_lruPrev.idx = _lruNext.idx = 0;
 }
 
 ResourceManager::Resource::~Resource() {
@@ -856,7 +996,7 @@ void ResourceManager::Resource::nuke() {
 	_address = 0;
 	_size = 0;
 	_flags = 0;
-	_status &= ~RS_MODIFIED;
+	_status &= ~(RS_MODIFIED | RS_PREFETCHED);
 }
 
 ResourceManager::ResTypeData::ResTypeData() {
@@ -872,6 +1012,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_epoch = 0;
+	_lruHead.type = _lruTail.type = rtInvalid;
+	_lruHead.idx = _lruTail.idx = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -898,6 +1041,8 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
+		if (isExpirable(type))
+			unlinkResource(type, idx);
 		_types[type][idx].nuke();
 	}
 }
@@ -1032,10 +1177,19 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+void ResourceManager::Resource::setPrefetched() {
+	_status |= RS_PREFETCHED;
+}
+
+bool ResourceManager::Resource::isPrefetched() const {
+	return (_status & RS_PREFETCHED) != 0;
+}
+
+void ResourceManager::Resource::clearPrefetched() {
+	_status &= ~RS_PREFETCHED;
+}
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1048,31 +1202,25 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
-		}
-
-		if (!best_type)
+	// The list starts with the resource with the highest counter. Those
+	// used since the counters were last increased (i.e. with a counter
+	// of 1) stay, and so do all which come after them.
+	ResourceLink link = _lruHead;
+	while (link.type != rtInvalid) {
+		const ResType type = (ResType)link.type;
+		const ResId idx = link.idx;
+		Resource &tmp = getLinkedResource(link);
+		link = tmp._lruNext;
+
+		if (getResourceCounter(type, idx) < 2)
 			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+
+		if (!tmp.isLocked() && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
+			nukeResource(type, idx);
+			if (size + _allocatedSize <= _minHeapThreshold)
+				break;
+		}
+	}
 
 	increaseResourceCounters();
 
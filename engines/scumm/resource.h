@@ -79,7 +79,17 @@ protected:
 	ScummEngine *_vm;
 
 public:
+	/**
+	 * Refers to a resource in the list of expirable resources; a type of
+	 * rtInvalid marks either end of the list.
+	 */
+	struct ResourceLink {
+		byte type;
+		ResId idx;
+	};
+
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -94,15 +104,22 @@ public:
 	protected:
 		/**
 		 * The uppermost bit indicates whether the resources is locked.
-		 * The lower 7 bits contain a counter. This counter measures roughly
-		 * how old the resource is; it starts out with a count of 1 and can go
-		 * as high as 127. When memory falls low resp. when the engine decides
-		 * that it should throw out some unused stuff, then it begins by
-		 * removing the resources with the highest counter (excluding locked
-		 * resources and resources that are known to be in use).
 		 */
 		byte _flags;
 
+		/**
+		 * The value of ResourceManager::_epoch when the resource was last
+		 * used. The difference to the current epoch makes up the counter,
+		 * see ResourceManager::getResourceCounter().
+		 */
+		uint32 _lastUsed;
+
+		/**
+		 * Neighbours in the list of loaded resources which can be expired,
+		 * ordered from the least to the most recently used one.
+		 */
+		ResourceLink _lruPrev, _lruNext;
+
 		/**
 		 * The status of the resource. Currently only one bit is used, which
 		 * indicates whether the resource is modified.
@@ -131,9 +148,6 @@ public:
 
 		void nuke();
 
-		inline void setResourceCounter(byte counter);
-		inline byte getResourceCounter() const;
-
 		void lock();
 		void unlock();
 		bool isLocked() const;
@@ -144,6 +158,11 @@ public:
 		void setOffHeap();
 		void setOnHeap();
 		bool isOffHeap() const;
+
+		/** The resource was loaded ahead of its use and not used yet. */
+		void setPrefetched();
+		bool isPrefetched() const;
+		void clearPrefetched();
 	};
 
 	/**
@@ -175,12 +194,21 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/** Incremented by increaseResourceCounters(), ages all resources at once. */
+	uint32 _epoch;
+
+	/** Least and most recently used end of the list of expirable resources. */
+	ResourceLink _lruHead, _lruTail;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
 
+	/** Whether size more bytes can be allocated without expiring any resource. */
+	bool hasHeapRoom(uint32 size) const { return size + _allocatedSize < _maxHeapThreshold; }
+
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
 
@@ -210,17 +238,22 @@ public:
 	void increaseExpireCounter();
 
 	/**
-	 * Update the specified resource's counter.
+	 * Update the specified resource's counter. The counter measures roughly
+	 * how old the resource is; it starts out with a count of 1 and can go
+	 * as high as 127. When memory falls low resp. when the engine decides
+	 * that it should throw out some unused stuff, then it begins by
+	 * removing the resources with the highest counter (excluding locked
+	 * resources and resources that are known to be in use).
 	 */
 	void setResourceCounter(ResType type, ResId idx, byte counter);
+	byte getResourceCounter(ResType type, ResId idx) const;
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
+	 * Increment the counter of all loaded resources, up to 127.
 	 * This is called by increaseExpireCounter and expireResources,
 	 * but also by ScummEngine::startScene.
 	 */
-	void increaseResourceCounters();
+	void increaseResourceCounters() { _epoch++; }
 
 	void resourceStats();
 
@@ -228,6 +261,12 @@ public:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+
+	/** Whether resources of this type are kept in the expiry list. */
+	bool isExpirable(ResType type) const { return _types[type]._mode != kDynamicResTypeMode; }
+	Resource &getLinkedResource(ResourceLink link) { return _types[link.type][link.idx]; }
+	void linkResource(ResType type, ResId idx, ResourceLink after);
+	void unlinkResource(ResType type, ResId idx);
 };
 
 } // End of namespace Scumm
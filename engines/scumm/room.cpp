@@ -131,6 +131,8 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	if (room != 0)
 		ensureResourceLoaded(rtRoom, room);
 
+	queueRoomPrefetch(_roomResource);
+
 	clearRoomObjects();
 
 	if (_currentRoom == 0) {
@@ -446,12 +446,10 @@ void ScummEngine::resetScriptPointer() {
  * The script resource may have moved because it might have been garbage
  * collected by ResourceManager::expireResources.
  */
-void ScummEngine::refreshScriptPointer() {
-	if (*_lastCodePtr != _scriptOrgPointer) {
-		long oldoffs = _scriptPointer - _scriptOrgPointer;
-		getScriptBaseAddress();
-		_scriptPointer = _scriptOrgPointer + oldoffs;
-	}
+void ScummEngine::rebaseScriptPointer() {
+	long oldoffs = _scriptPointer - _scriptOrgPointer;
+	getScriptBaseAddress();
+	_scriptPointer = _scriptOrgPointer + oldoffs;
 }
 
 /** Execute a script - Read opcode, and execute it from the table */
@@ -481,11 +479,24 @@ void ScummEngine::executeScript() {
 			debugN("\n");
 		}
 
+		if (_opcodeCounts)
+			_opcodeCounts[_opcode]++;
+
 		executeOpcode(_opcode);
 
 	}
 }
 
+void ScummEngine::enableOpcodeProfiling(bool enable) {
+	delete[] _opcodeCounts;
+	_opcodeCounts = 0;
+
+	if (enable) {
+		_opcodeCounts = new uint32[256];
+		memset(_opcodeCounts, 0, 256 * sizeof(uint32));
+	}
+}
+
 void ScummEngine::executeOpcode(byte i) {
 	if (_opcodes[i].proc && _opcodes[i].proc->isValid())
 		(*_opcodes[i].proc)();
@@ -502,11 +513,6 @@ const char *ScummEngine::getOpcodeDesc(byte i) {
 #endif
 }
 
-byte ScummEngine::fetchScriptByte() {
-	refreshScriptPointer();
-	return *_scriptPointer++;
-}
-
 uint ScummEngine::fetchScriptWord() {
 	refreshScriptPointer();
 	uint a = READ_LE_UINT16(_scriptPointer);
@@ -518,17 +524,6 @@ int ScummEngine::fetchScriptWordSigned() {
 	return (int16)fetchScriptWord();
 }
 
-uint ScummEngine::fetchScriptDWord() {
-	refreshScriptPointer();
-	uint a = READ_LE_UINT32(_scriptPointer);
-	_scriptPointer += 4;
-	return a;
-}
-
-int ScummEngine::fetchScriptDWordSigned() {
-	return (int32)fetchScriptDWord();
-}
-
 int ScummEngine::readVar(uint var) {
 	int a;
 
@@ -217,6 +217,11 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	_scriptPointer = NULL;
 	_scriptOrgPointer = NULL;
 	_opcode = 0;
+	_opcodeCounts = NULL;
+	_prefetchEnabled = true;
+	_prefetchNext = 0;
+	_prefetchStats.reset(0);
+	_lastPrefetchStats.reset(0);
 	vm.numNestedScripts = 0;
 	_lastCodePtr = NULL;
 	_scummStackPos = 0;
@@ -585,6 +590,8 @@ ScummEngine::~ScummEngine() {
 
 	_mixer->stopAll();
 
+	delete[] _opcodeCounts;
+
 	if (_actors) {
 		for (int i = 0; i < _numActors; ++i)
 			delete _actors[i];
@@ -1309,7 +1316,11 @@ void ScummEngine::setupScumm() {
 		maxHeapThreshold = 550000;
 	}
 
-	_res->setHeapThreshold(400000, maxHeapThreshold);
+	// Allow more (or less) memory to be used for a specific target, in KB
+	if (ConfMan.hasKey("heap_size") && ConfMan.getInt("heap_size") > 0)
+		maxHeapThreshold = ConfMan.getInt("heap_size") * 1024;
+
+	_res->setHeapThreshold(MIN(400000, maxHeapThreshold), maxHeapThreshold);
 
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _outputPixelFormat.bytesPerPixel);
@@ -2015,7 +2026,12 @@ void ScummEngine::waitForTimer(int msec_delay) {
 		_system->updateScreen();
 		if (_system->getMillis() >= start_time + msec_delay)
 			break;
-		_system->delayMillis(10);
+
+		// Spend the rest of the frame decoding the next frames of a
+		// running video, or reading in the resources of the current
+		// room, so that using them later does not stall
+		if (!decodeVideoAhead() && !prefetchResource())
+			_system->delayMillis(10);
 	}
 }
 
@@ -2192,6 +2208,10 @@ load_game:
 }
 
 #ifdef ENABLE_HE
+bool ScummEngine_v90he::decodeVideoAhead() {
+	return _moviePlay->decodeAhead();
+}
+
 void ScummEngine_v90he::scummLoop(int delta) {
 	_moviePlay->handleNextFrame();
 	if (_game.heversion >= 98) {
@@ -25,6 +25,7 @@
 
 #include "engines/engine.h"
 
+#include "common/array.h"
 #include "common/endian.h"
 #include "common/events.h"
 #include "common/file.h"
@@ -456,6 +457,11 @@ protected:
 	virtual void parseEvent(Common::Event event);
 
 	void waitForTimer(int msec_delay);
+	/**
+	 * Do work for upcoming frames of a running video while waiting for the
+	 * timer. Returns false if there is nothing to do.
+	 */
+	virtual bool decodeVideoAhead() { return false; }
 	virtual void processInput();
 	virtual void processKeyboard(Common::KeyState lastKeyHit);
 	virtual void clearClickedStatus();
@@ -635,6 +641,12 @@ protected:
 
 	OpcodeEntry _opcodes[256];
 
+	/**
+	 * Number of times each opcode was executed since profiling was enabled
+	 * with enableOpcodeProfiling(), or 0 if it is disabled.
+	 */
+	uint32 *_opcodeCounts;
+
 	virtual void setupOpcodes() = 0;
 	void executeOpcode(byte i);
 	const char *getOpcodeDesc(byte i);
@@ -646,6 +658,12 @@ protected:
 	void startManiac();
 
 public:
+	/** Start or stop counting the executed opcodes, see getOpcodeCounts(). */
+	void enableOpcodeProfiling(bool enable);
+	/** Returns the number of times each opcode was executed, or 0 if not profiling. */
+	const uint32 *getOpcodeCounts() const { return _opcodeCounts; }
+	const char *getOpcodeName(byte i) { return getOpcodeDesc(i); }
+
 	void runScript(int script, bool freezeResistant, bool recursive, int *lvarptr, int cycle = 0);
 	void stopScript(int script);
 	void nukeArrays(byte scriptSlot);
@@ -679,12 +697,31 @@ protected:
 	void resetScriptPointer();
 	int getVerbEntrypoint(int obj, int entry);
 
-	void refreshScriptPointer();
-	byte fetchScriptByte();
+	/**
+	 * Checks whether the resource that contains the active script moved,
+	 * which only takes a comparison unless it actually did.
+	 */
+	void refreshScriptPointer() {
+		if (*_lastCodePtr != _scriptOrgPointer)
+			rebaseScriptPointer();
+	}
+	void rebaseScriptPointer();
+
+	// The fetch functions are inline, the opcodes use them for every single
+	// operand they read
+	byte fetchScriptByte() {
+		refreshScriptPointer();
+		return *_scriptPointer++;
+	}
 	virtual uint fetchScriptWord();
 	virtual int fetchScriptWordSigned();
-	uint fetchScriptDWord();
-	int fetchScriptDWordSigned();
+	uint fetchScriptDWord() {
+		refreshScriptPointer();
+		uint a = READ_LE_UINT32(_scriptPointer);
+		_scriptPointer += 4;
+		return a;
+	}
+	int fetchScriptDWordSigned() { return (int32)fetchScriptDWord(); }
 	void ignoreScriptWord() { fetchScriptWord(); }
 	void ignoreScriptByte() { fetchScriptByte(); }
 	void push(int a);
@@ -741,6 +778,32 @@ public:
 	byte *getStringAddressVar(int i);
 	void ensureResourceLoaded(ResType type, ResId idx);
 
+	/**
+	 * Statistics of the resource prefetching for one room, see
+	 * queueRoomPrefetch().
+	 */
+	struct PrefetchStats {
+		int room;
+		uint queued;		///< resources of the room which were not loaded yet
+		uint loaded;		///< resources loaded ahead of their use
+		uint hits;			///< prefetched resources used afterwards
+		uint misses;		///< scripts, costumes and sounds loaded on demand
+		uint32 prefetchBytes;
+		uint32 demandBytes;
+
+		void reset(int r) {
+			room = r;
+			queued = loaded = hits = misses = 0;
+			prefetchBytes = demandBytes = 0;
+		}
+	};
+
+	void enablePrefetch(bool enable) { _prefetchEnabled = enable; }
+	bool isPrefetchEnabled() const { return _prefetchEnabled; }
+	/** Statistics for the current room and the one before it. */
+	const PrefetchStats &getPrefetchStats(bool previous) const { return previous ? _lastPrefetchStats : _prefetchStats; }
+	uint getPrefetchPending() const { return _prefetchQueue.size() - _prefetchNext; }
+
 protected:
 	int readSoundResource(ResId idx);
 	int readSoundResourceSmallHeader(ResId idx);
@@ -761,6 +824,25 @@ protected:
 	virtual void loadCharset(int i);
 	void nukeCharset(int i);
 
+	/**
+	 * Queue the scripts, costumes and sounds the index lists for the given
+	 * room, so that prefetchResource() can load them while the engine waits
+	 * for the next frame, instead of when they are first used.
+	 */
+	void queueRoomPrefetch(int room);
+	/** Load the next queued resource. Returns false if none is left. */
+	bool prefetchResource();
+
+	struct PrefetchEntry {
+		ResType type;
+		ResId idx;
+	};
+
+	bool _prefetchEnabled;
+	Common::Array<PrefetchEntry> _prefetchQueue;
+	uint _prefetchNext;
+	PrefetchStats _prefetchStats, _lastPrefetchStats;
+
 	int _lastLoadedRoom;
 public:
 	const byte *findResourceData(uint32 tag, const byte *ptr);
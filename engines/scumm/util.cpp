@@ -30,10 +30,8 @@ namespace Scumm {
 #pragma mark --- Utilities ---
 #pragma mark -
 
-void assertRange(int min, int value, int max, const char *desc) {
-	if (value < min || value > max) {
-		error("%s %d is out of bounds (%d,%d)", desc, value, min, max);
-	}
+void rangeError(int min, int value, int max, const char *desc) {
+	error("%s %d is out of bounds (%d,%d)", desc, value, min, max);
 }
 
 /**
@@ -38,7 +38,16 @@ int normalizeAngle(int angle);
 int fromSimpleDir(int dirtype, int dir);
 int toSimpleDir(int dirtype, int dir);
 
-void assertRange(int min, int value, int max, const char *desc);
+void NORETURN_PRE rangeError(int min, int value, int max, const char *desc) NORETURN_POST;
+
+/**
+ * Errors out if value is not within [min, max]. Inline, as the script
+ * interpreter checks every variable access with it.
+ */
+inline void assertRange(int min, int value, int max, const char *desc) {
+	if (value < min || value > max)
+		rangeError(min, value, max, desc);
+}
 
 } // End of namespace Scumm
 
@@ -225,6 +225,10 @@ void Logic::expressChangeSession(uint32 sesh_id) {
 	_router->clearWalkGridList();
 	_vm->_sound->clearFxQueue(false);
 	_router->freeAllRouteMem();
+
+	// Start loading the objects of the new session in idle time
+	_vm->_resman->reportStalls();
+	_vm->_resman->readAheadRunList(sesh_id);
 }
 
 /**
@@ -70,16 +70,27 @@ ResourceManager::ResourceManager(Sword2Engine *vm) {
 	_totalClusters = 0;
 	_resList = NULL;
 	_resConvTable = NULL;
-	_cacheStart = NULL;
-	_cacheEnd = NULL;
+	for (int i = 0; i < NUM_SIZE_CLASSES; i++)
+		_cacheStart[i] = _cacheEnd[i] = NULL;
 	_usedMem = 0;
+
+	_readAheadFile = NULL;
+	_readAheadCluFile = 0;
+
+	_stallCount = 0;
+	_stallBytes = 0;
+	_stallTime = 0;
+	_readAheadCount = 0;
 }
 
 ResourceManager::~ResourceManager() {
-	Resource *res = _cacheStart;
-	while (res) {
-		_vm->_memory->memFree(res->ptr);
-		res = res->next;
+	closeReadAheadFile();
+	for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+		Resource *res = _cacheStart[i];
+		while (res) {
+			_vm->_memory->memFree(res->ptr);
+			res = res->next;
+		}
 	}
 	for (uint i = 0; i < _totalClusters; i++)
 		free(_resFiles[i].entryTab);
@@ -269,15 +280,13 @@ byte *ResourceManager::openResource(uint32 res, bool dump) {
 	// Is the resource in memory already? If not, load it.
 
 	if (!_resList[res].ptr) {
+		uint32 startTime = _vm->_system->getMillis();
+
 		// Fetch the correct file and read in the correct portion.
 		uint16 cluFileNum = _resConvTable[res * 2]; // points to the number of the ascii filename
 
 		assert(cluFileNum != 0xffff);
 
-		// Relative resource within the file
-		// First we have to find the file via the _resConvTable
-		uint16 actual_res = _resConvTable[(res * 2) + 1];
-
 		debug(5, "openResource %s res %d", _resFiles[cluFileNum].fileName, res);
 
 		// If we're loading a cluster that's only available from one
@@ -300,21 +309,9 @@ byte *ResourceManager::openResource(uint32 res, bool dump) {
 			readCluIndex(cluFileNum, file);
 		}
 
-		assert(_resFiles[cluFileNum].entryTab);
+		readResource(res, file);
 
-		uint32 pos = _resFiles[cluFileNum].entryTab[actual_res * 2 + 0];
-		uint32 len = _resFiles[cluFileNum].entryTab[actual_res * 2 + 1];
-
-		file->seek(pos, SEEK_SET);
-
-		debug(6, "res len %d", len);
-
-		// Ok, we know the length so try and allocate the memory.
-		_resList[res].ptr = _vm->_memory->memAlloc(len, res);
-		_resList[res].size = len;
-		_resList[res].refCount = 0;
-
-		file->read(_resList[res].ptr, len);
+		uint32 len = _resList[res].size;
 
 		debug(3, "Loaded resource '%s' (%d) from '%s' on CD %d (%d)", fetchName(_resList[res].ptr), res, _resFiles[cluFileNum].fileName, getCD(), _resFiles[cluFileNum].cd);
 
@@ -376,12 +373,38 @@ byte *ResourceManager::openResource(uint32 res, bool dump) {
 			}
 		}
 
+		// The cluster is open anyway, so pick up whatever else we expect
+		// to need from it. The list is sorted by position in the file.
+
+		for (uint i = 0; i < _readAheadList.size();) {
+			uint32 next = _readAheadList[i];
+
+			if (_resConvTable[next * 2] != cluFileNum) {
+				i++;
+				continue;
+			}
+
+			_readAheadList.remove_at(i);
+
+			uint16 actual_res = _resConvTable[(next * 2) + 1];
+
+			if (_resList[next].ptr || _usedMem + _resFiles[cluFileNum].entryTab[actual_res * 2 + 1] > MAX_MEM_CACHE)
+				continue;
+
+			readResource(next, file);
+			addToCacheList(_resList + next);
+			_readAheadCount++;
+		}
+
 		// close the cluster
 		file->close();
 		delete file;
 
-		_usedMem += len;
 		checkMemUsage();
+
+		_stallCount++;
+		_stallBytes += len;
+		_stallTime += _vm->_system->getMillis() - startTime;
 	} else if (_resList[res].refCount == 0)
 		removeFromCacheList(_resList + res);
 
@@ -390,6 +413,34 @@ byte *ResourceManager::openResource(uint32 res, bool dump) {
 	return _resList[res].ptr;
 }
 
+/**
+ * Reads a resource from an open cluster file, whose index table must already
+ * have been read. The resource is not referenced, nor put in the cache list.
+ */
+
+void ResourceManager::readResource(uint32 res, Common::File *file) {
+	uint16 cluFileNum = _resConvTable[res * 2];
+	uint16 actual_res = _resConvTable[(res * 2) + 1];
+
+	assert(_resFiles[cluFileNum].entryTab);
+
+	uint32 pos = _resFiles[cluFileNum].entryTab[actual_res * 2 + 0];
+	uint32 len = _resFiles[cluFileNum].entryTab[actual_res * 2 + 1];
+
+	file->seek(pos, SEEK_SET);
+
+	debug(6, "res len %d", len);
+
+	// Ok, we know the length so try and allocate the memory.
+	_resList[res].ptr = _vm->_memory->memAlloc(len, res);
+	_resList[res].size = len;
+	_resList[res].refCount = 0;
+
+	file->read(_resList[res].ptr, len);
+
+	_usedMem += len;
+}
+
 void ResourceManager::closeResource(uint32 res) {
 	assert(res < _totalResFiles);
 
@@ -416,12 +467,23 @@ void ResourceManager::closeResource(uint32 res) {
 	// specific memory address - was considered a bad thing.
 }
 
+int ResourceManager::getSizeClass(uint32 size) {
+	int sizeClass = 0;
+
+	while (sizeClass < NUM_SIZE_CLASSES - 1 && size >= (4096U << (2 * sizeClass)))
+		sizeClass++;
+
+	return sizeClass;
+}
+
 void ResourceManager::removeFromCacheList(Resource *res) {
-	if (_cacheStart == res)
-		_cacheStart = res->next;
+	int sizeClass = getSizeClass(res->size);
+
+	if (_cacheStart[sizeClass] == res)
+		_cacheStart[sizeClass] = res->next;
 
-	if (_cacheEnd == res)
-		_cacheEnd = res->prev;
+	if (_cacheEnd[sizeClass] == res)
+		_cacheEnd[sizeClass] = res->prev;
 
 	if (res->prev)
 		res->prev->next = res->next;
@@ -431,13 +493,15 @@ void ResourceManager::removeFromCacheList(Resource *res) {
 }
 
 void ResourceManager::addToCacheList(Resource *res) {
+	int sizeClass = getSizeClass(res->size);
+
 	res->prev = NULL;
-	res->next = _cacheStart;
-	if (_cacheStart)
-		_cacheStart->prev = res;
-	_cacheStart = res;
-	if (!_cacheEnd)
-		_cacheEnd = res;
+	res->next = _cacheStart[sizeClass];
+	if (_cacheStart[sizeClass])
+		_cacheStart[sizeClass]->prev = res;
+	_cacheStart[sizeClass] = res;
+	if (!_cacheEnd[sizeClass])
+		_cacheEnd[sizeClass] = res;
 }
 
 Common::File *ResourceManager::openCluFile(uint16 fileNum) {
@@ -560,10 +624,26 @@ uint32 ResourceManager::fetchLen(uint32 res) {
 void ResourceManager::checkMemUsage() {
 	while (_usedMem > MAX_MEM_CACHE) {
 		// we're using up more memory than we wanted to. free some old stuff.
+		// Rather than throwing out lots of small resources, each of which
+		// costs a disk seek to get back, pick the smallest size class that
+		// frees enough memory in one go. Failing that, use the largest one
+		// that has anything in it.
+		int wanted = getSizeClass(_usedMem - MAX_MEM_CACHE);
+		int sizeClass = wanted;
+
+		while (sizeClass < NUM_SIZE_CLASSES && !_cacheEnd[sizeClass])
+			sizeClass++;
+
+		if (sizeClass == NUM_SIZE_CLASSES) {
+			sizeClass = wanted - 1;
+			while (sizeClass >= 0 && !_cacheEnd[sizeClass])
+				sizeClass--;
+		}
+
 		// Newly loaded objects are added to the start of the list,
 		// we start freeing from the end, to free the oldest items first
-		if (_cacheEnd) {
-			Resource *tmp = _cacheEnd;
+		if (sizeClass >= 0) {
+			Resource *tmp = _cacheEnd[sizeClass];
 			assert((tmp->refCount == 0) && (tmp->ptr) && (tmp->next == NULL));
 			removeFromCacheList(tmp);
 
@@ -577,6 +657,106 @@ void ResourceManager::checkMemUsage() {
 	}
 }
 
+/**
+ * Queues the objects of a run list, so that they can be loaded while the
+ * engine has nothing better to do. Called when the session changes, since
+ * the objects of the new screen are about to be needed.
+ */
+
+void ResourceManager::readAheadRunList(uint32 runList) {
+	_readAheadList.clear();
+
+	if (!checkValid(runList))
+		return;
+
+	byte *list = openResource(runList) + ResHeader::size();
+
+	for (uint32 id = READ_LE_UINT32(list); id; list += 4, id = READ_LE_UINT32(list)) {
+		if (!checkValid(id) || _resList[id].ptr)
+			continue;
+
+		// Keep the list in cluster file order, to avoid needless seeking
+		uint32 key = clusterOrder(id);
+		uint i = _readAheadList.size();
+
+		while (i > 0 && clusterOrder(_readAheadList[i - 1]) > key)
+			i--;
+
+		_readAheadList.insert_at(i, id);
+	}
+
+	closeResource(runList);
+
+	debug(5, "readAheadRunList: %d resources queued from run list %d", _readAheadList.size(), runList);
+}
+
+/**
+ * Loads one of the queued resources, if any. Unlike openResource(), this never
+ * asks for a CD: resources that can't be found right now are simply skipped,
+ * and will be loaded on demand as before. Nothing is thrown out of the cache
+ * to make room for them either.
+ * @return true if a resource was loaded
+ */
+
+bool ResourceManager::readAhead() {
+	while (!_readAheadList.empty()) {
+		uint32 res = _readAheadList.remove_at(0);
+
+		if (_resList[res].ptr)
+			continue;
+
+		uint16 cluFileNum = _resConvTable[res * 2];
+
+		if (!_readAheadFile || _readAheadCluFile != cluFileNum) {
+			closeReadAheadFile();
+
+			_readAheadFile = new Common::File;
+			if (!_readAheadFile->open(_resFiles[cluFileNum].fileName)) {
+				closeReadAheadFile();
+				continue;
+			}
+
+			_readAheadCluFile = cluFileNum;
+
+			if (_resFiles[cluFileNum].entryTab == NULL)
+				readCluIndex(cluFileNum, _readAheadFile);
+		}
+
+		uint16 actual_res = _resConvTable[(res * 2) + 1];
+
+		if (_usedMem + _resFiles[cluFileNum].entryTab[actual_res * 2 + 1] > MAX_MEM_CACHE)
+			continue;
+
+		readResource(res, _readAheadFile);
+		addToCacheList(_resList + res);
+		_readAheadCount++;
+
+		debug(5, "readAhead %s res %d", _resFiles[cluFileNum].fileName, res);
+		return true;
+	}
+
+	closeReadAheadFile();
+	return false;
+}
+
+void ResourceManager::closeReadAheadFile() {
+	delete _readAheadFile;
+	_readAheadFile = NULL;
+}
+
+/**
+ * Logs how much loading the engine had to wait for since the last call.
+ */
+
+void ResourceManager::reportStalls() {
+	debug(1, "Resources loaded on demand: %d (%d bytes, %d ms), ahead of time: %d", _stallCount, _stallBytes, _stallTime, _readAheadCount);
+
+	_stallCount = 0;
+	_stallBytes = 0;
+	_stallTime = 0;
+	_readAheadCount = 0;
+}
+
 void ResourceManager::remove(int res) {
 	if (_resList[res].ptr) {
 		removeFromCacheList(_resList + res);
@@ -25,6 +25,8 @@
 #ifndef	SWORD2_RESMAN_H
 #define	SWORD2_RESMAN_H
 
+#include "common/array.h"
+
 namespace Common {
 class File;
 }
@@ -32,6 +34,10 @@ class File;
 #define MAX_MEM_CACHE (8 * 1024 * 1024) // we keep up to 8 megs of resource data files in memory
 #define	MAX_res_files 20
 
+// Unused resources are kept in one LRU list for each of these size classes:
+// below 4K, 16K, 64K, 256K and anything bigger
+#define NUM_SIZE_CLASSES 5
+
 namespace Sword2 {
 
 class Sword2Engine;
@@ -54,9 +60,17 @@ class ResourceManager {
 private:
 	Common::File *openCluFile(uint16 fileNum);
 	void readCluIndex(uint16 fileNum, Common::File *file);
+	void readResource(uint32 res, Common::File *file);
+	int getSizeClass(uint32 size);
 	void removeFromCacheList(Resource *res);
 	void addToCacheList(Resource *res);
 	void checkMemUsage();
+	void closeReadAheadFile();
+
+	// Orders resources by cluster file, then by position in that file
+	uint32 clusterOrder(uint32 res) const {
+		return ((uint32)_resConvTable[res * 2] << 16) | _resConvTable[(res * 2) + 1];
+	}
 
 	Sword2Engine *_vm;
 
@@ -70,9 +84,20 @@ private:
 	ResourceFile _resFiles[MAX_res_files];
 	Resource *_resList;
 
-	Resource *_cacheStart, *_cacheEnd;
+	Resource *_cacheStart[NUM_SIZE_CLASSES], *_cacheEnd[NUM_SIZE_CLASSES];
 	uint32 _usedMem; // amount of used memory in bytes
 
+	// Resources expected to be needed soon, loaded while the engine waits
+	Common::Array<uint32> _readAheadList;
+	Common::File *_readAheadFile;
+	uint16 _readAheadCluFile;
+
+	// Disk access statistics since the last change of session
+	uint32 _stallCount;	// resources loaded on demand
+	uint32 _stallBytes;
+	uint32 _stallTime;	// milliseconds spent loading them
+	uint32 _readAheadCount;	// resources loaded ahead of time
+
 public:
 	ResourceManager(Sword2Engine *vm);	// read in the config file
 	~ResourceManager();
@@ -87,6 +112,10 @@ public:
 	byte *openResource(uint32 res, bool dump = false);
 	void closeResource(uint32 res);
 
+	void readAheadRunList(uint32 runList);
+	bool readAhead();
+	void reportStalls();
+
 	bool checkValid(uint32 res);
 	uint32 fetchLen(uint32 res);
 	uint8 fetchType(byte *ptr);
@@ -772,7 +772,10 @@ void Sword2Engine::sleepUntil(uint32 time) {
 		// redraw the entire scene.
 		_mouse->processMenu();
 		_screen->updateDisplay(false);
-		_system->delayMillis(10);
+
+		// Use the spare time to load resources we expect to need soon
+		if (!_resman->readAhead())
+			_system->delayMillis(10);
 	}
 }
 
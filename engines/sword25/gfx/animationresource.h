@@ -80,6 +80,11 @@ public:
 		return _valid;
 	}
 
+	virtual uint getSize() const {
+		// The frame images are resources of their own
+		return _frames.size() * sizeof(Frame);
+	}
+
 private:
 	bool _valid;
 
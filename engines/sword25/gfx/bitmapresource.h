@@ -60,6 +60,10 @@ public:
 					_pImage(pImage), Resource(filename, Resource::TYPE_BITMAP) {}
 	virtual ~BitmapResource() { delete _pImage; }
 
+	virtual uint getSize() const {
+		return _pImage ? _pImage->getSize() : 0;
+	}
+
 	/**
 	    @brief Gibt zurck, ob das Objekt einen gltigen Zustand hat.
 	*/
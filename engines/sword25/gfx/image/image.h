@@ -85,6 +85,14 @@ public:
 	*/
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const = 0;
 
+	/**
+	    @brief Returns the number of bytes the image occupies in memory
+	*/
+	virtual uint getSize() const {
+		// All image classes keep their pixels in 32 bit ARGB
+		return getWidth() * getHeight() * 4;
+	}
+
 	//@}
 
 	//@{
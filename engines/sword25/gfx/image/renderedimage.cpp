@@ -40,6 +40,13 @@
 
 #include "common/system.h"
 
+// The blending is done with SSE2, if the target architecture guarantees
+// it or it can be picked at runtime
+#if defined(SCUMM_LITTLE_ENDIAN) && ((defined(__i386__) || defined(__x86_64__)) && GCC_ATLEAST(4, 9) || defined(__SSE2__))
+#define USE_BLEND_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Sword25 {
 
 // -----------------------------------------------------------------------------
@@ -173,6 +180,8 @@ RenderedImage::RenderedImage() : _width(0), _height(0), _data(0) {
 // -----------------------------------------------------------------------------
 
 RenderedImage::~RenderedImage() {
+	flushScaledVariants();
+
 	if (_doCleanup)
 		delete[] _data;
 }
@@ -193,6 +202,8 @@ bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, ui
 		return false;
 	}
 
+	flushScaledVariants();
+
 	const byte *in = &pixeldata[offset];
 	byte *out = _data;
 
@@ -206,6 +217,8 @@ bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, ui
 }
 
 void RenderedImage::replaceContent(byte *pixeldata, int width, int height) {
+	flushScaledVariants();
+
 	_width = width;
 	_height = height;
 	_data = pixeldata;
@@ -219,6 +232,219 @@ uint RenderedImage::getPixel(int x, int y) {
 
 // -----------------------------------------------------------------------------
 
+typedef void BlendRowProc(const byte *in, int inStep, byte *out, int width, int ca, int cr, int cg, int cb);
+
+/**
+ * Blends a row of an image onto the back surface.
+ * @param in		the first source pixel
+ * @param inStep	the byte offset between source pixels, negative for flipped images
+ * @param out		the first destination pixel
+ * @param width		the number of pixels
+ * @param ca, cr, cg, cb	the modulation color, with the color components
+ *                      already scaled by the alpha
+ */
+static void blendRowC(const byte *in, int inStep, byte *out, int width, int ca, int cr, int cg, int cb) {
+	for (int j = 0; j < width; j++) {
+		uint32 pix = *(const uint32 *)in;
+		int b = (pix >> 0) & 0xff;
+		int g = (pix >> 8) & 0xff;
+		int r = (pix >> 16) & 0xff;
+		int a = (pix >> 24) & 0xff;
+		in += inStep;
+
+		if (ca != 255) {
+			a = a * ca >> 8;
+		}
+
+		switch (a) {
+		case 0: // Full transparency
+			out += 4;
+			break;
+		case 255: // Full opacity
+#if defined(SCUMM_LITTLE_ENDIAN)
+			if (cb != 255)
+				*out++ = (b * cb) >> 8;
+			else
+				*out++ = b;
+
+			if (cg != 255)
+				*out++ = (g * cg) >> 8;
+			else
+				*out++ = g;
+
+			if (cr != 255)
+				*out++ = (r * cr) >> 8;
+			else
+				*out++ = r;
+
+			*out++ = a;
+#else
+			*out++ = a;
+
+			if (cr != 255)
+				*out++ = (r * cr) >> 8;
+			else
+				*out++ = r;
+
+			if (cg != 255)
+				*out++ = (g * cg) >> 8;
+			else
+				*out++ = g;
+
+			if (cb != 255)
+				*out++ = (b * cb) >> 8;
+			else
+				*out++ = b;
+#endif
+			break;
+
+		default: // alpha blending
+#if defined(SCUMM_LITTLE_ENDIAN)
+			if (cb == 0)
+				*out = 0;
+			else if (cb != 255)
+				*out += ((b - *out) * a * cb) >> 16;
+			else
+				*out += ((b - *out) * a) >> 8;
+			out++;
+			if (cg == 0)
+				*out = 0;
+			else if (cg != 255)
+				*out += ((g - *out) * a * cg) >> 16;
+			else
+				*out += ((g - *out) * a) >> 8;
+			out++;
+			if (cr == 0)
+				*out = 0;
+			else if (cr != 255)
+				*out += ((r - *out) * a * cr) >> 16;
+			else
+				*out += ((r - *out) * a) >> 8;
+			out++;
+			*out = 255;
+			out++;
+#else
+			*out = 255;
+			out++;
+			if (cr == 0)
+				*out = 0;
+			else if (cr != 255)
+				*out += ((r - *out) * a * cr) >> 16;
+			else
+				*out += ((r - *out) * a) >> 8;
+			out++;
+			if (cg == 0)
+				*out = 0;
+			else if (cg != 255)
+				*out += ((g - *out) * a * cg) >> 16;
+			else
+				*out += ((g - *out) * a) >> 8;
+			out++;
+			if (cb == 0)
+				*out = 0;
+			else if (cb != 255)
+				*out += ((b - *out) * a * cb) >> 16;
+			else
+				*out += ((b - *out) * a) >> 8;
+			out++;
+#endif
+		}
+	}
+}
+
+#ifdef USE_BLEND_SSE2
+
+#ifdef __SSE2__
+#define TARGET_SSE2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+
+TARGET_SSE2
+static inline __m128i select_SSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/**
+ * Blends two pixels, unpacked to one 16 bit word per channel, exactly like
+ * blendRowC() does.
+ */
+TARGET_SSE2
+static inline __m128i blendPixels_SSE2(__m128i src, __m128i dst, int ca, __m128i alphaMod,
+                                       __m128i color, __m128i untinted, __m128i black) {
+	const __m128i alphaChannel = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+
+	// Spread the alpha of each pixel over all of its channels
+	__m128i a = _mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3));
+	a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+	if (ca != 255)
+		a = _mm_srli_epi16(_mm_mullo_epi16(a, alphaMod), 8);
+
+	// Full opacity: the tinted channels are scaled by the color
+	const __m128i opaque = select_SSE2(untinted, src, _mm_srli_epi16(_mm_mullo_epi16(src, color), 8));
+
+	// Alpha blending: dst += ((src - dst) * a * c) >> 16, or
+	// dst += ((src - dst) * a) >> 8 for untinted channels. Both are the high
+	// word of the product with a factor, which may be too large for a signed
+	// word, so the product of its sign bit is added back.
+	const __m128i factor = select_SSE2(untinted, _mm_slli_epi16(a, 8), _mm_mullo_epi16(a, color));
+	const __m128i diff = _mm_sub_epi16(src, dst);
+	__m128i blended = _mm_add_epi16(_mm_mulhi_epi16(diff, factor), _mm_and_si128(diff, _mm_srai_epi16(factor, 15)));
+	blended = _mm_or_si128(_mm_add_epi16(dst, blended), alphaChannel);
+	blended = _mm_andnot_si128(black, blended);
+
+	const __m128i transparent = _mm_cmpeq_epi16(a, _mm_setzero_si128());
+	const __m128i full = _mm_cmpeq_epi16(a, _mm_set1_epi16(255));
+	return select_SSE2(transparent, dst, select_SSE2(full, opaque, blended));
+}
+
+TARGET_SSE2
+static void blendRowSSE2(const byte *in, int inStep, byte *out, int width, int ca, int cr, int cg, int cb) {
+	const __m128i zero = _mm_setzero_si128();
+	// Modulation per channel, in the order the pixels are stored. The
+	// alpha channel is never tinted.
+	const __m128i color = _mm_set_epi16(255, cr, cg, cb, 255, cr, cg, cb);
+	const __m128i untinted = _mm_cmpeq_epi16(color, _mm_set1_epi16(255));
+	const __m128i black = _mm_cmpeq_epi16(color, zero);
+	const __m128i alphaMod = _mm_set1_epi16(ca);
+
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		__m128i src;
+		if (inStep > 0) {
+			src = _mm_loadu_si128((const __m128i *)in);
+		} else {
+			// Flipped, read the four pixels ending at in backwards
+			src = _mm_loadu_si128((const __m128i *)(in - 12));
+			src = _mm_shuffle_epi32(src, _MM_SHUFFLE(0, 1, 2, 3));
+		}
+		in += 4 * inStep;
+
+		const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+		const __m128i lo = blendPixels_SSE2(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero),
+		                                    ca, alphaMod, color, untinted, black);
+		const __m128i hi = blendPixels_SSE2(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero),
+		                                    ca, alphaMod, color, untinted, black);
+		_mm_storeu_si128((__m128i *)out, _mm_packus_epi16(lo, hi));
+		out += 16;
+	}
+
+	blendRowC(in, inStep, out, width - x, ca, cr, cg, cb);
+}
+
+#endif // #ifdef USE_BLEND_SSE2
+
+static BlendRowProc *chooseBlendRow() {
+#ifdef USE_BLEND_SSE2
+#ifndef __SSE2__
+	if (__builtin_cpu_supports("sse2"))
+#endif
+		return blendRowSSE2;
+#endif
+
+	return blendRowC;
+}
+
 bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height) {
 	int ca = (color >> 24) & 0xff;
 
@@ -238,6 +464,9 @@ bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRe
 		cb = cb * ca >> 8;
 	}
 
+	// Pick the fastest version of the blending the CPU supports, only once
+	static BlendRowProc *const blendRow = chooseBlendRow();
+
 	// Create an encapsulating surface for the data
 	Graphics::Surface srcImage;
 	// TODO: Is the data really in the screen format?
@@ -271,173 +500,57 @@ bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRe
 	height = height * 2 / 3;
 #endif
 
-	Graphics::Surface *img;
-	Graphics::Surface *imgScaled = NULL;
-	byte *savedPixels = NULL;
+	Graphics::Surface img;
 	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = scale(srcImage, width, height);
-		savedPixels = (byte *)img->pixels;
+		// Scale the image, or reuse the result of an earlier blit
+		Common::Rect srcRect = pPartRect ? *pPartRect : Common::Rect(_width, _height);
+		img = *getScaledVariant(srcImage, srcRect, width, height);
 	} else {
-		img = &srcImage;
+		img = srcImage;
 	}
 
 	// Handle off-screen clipping
 	if (posY < 0) {
-		img->h = MAX(0, (int)img->h - -posY);
-		img->pixels = (byte *)img->pixels + img->pitch * -posY;
+		img.h = MAX(0, (int)img.h - -posY);
+		img.pixels = (byte *)img.pixels + img.pitch * -posY;
 		posY = 0;
 	}
 
 	if (posX < 0) {
-		img->w = MAX(0, (int)img->w - -posX);
-		img->pixels = (byte *)img->pixels + (-posX * 4);
+		img.w = MAX(0, (int)img.w - -posX);
+		img.pixels = (byte *)img.pixels + (-posX * 4);
 		posX = 0;
 	}
 
-	img->w = CLIP((int)img->w, 0, (int)MAX((int)_backSurface->w - posX, 0));
-	img->h = CLIP((int)img->h, 0, (int)MAX((int)_backSurface->h - posY, 0));
+	img.w = CLIP((int)img.w, 0, (int)MAX((int)_backSurface->w - posX, 0));
+	img.h = CLIP((int)img.h, 0, (int)MAX((int)_backSurface->h - posY, 0));
 
-	if ((img->w > 0) && (img->h > 0)) {
+	if ((img.w > 0) && (img.h > 0)) {
 		int xp = 0, yp = 0;
 
 		int inStep = 4;
-		int inoStep = img->pitch;
+		int inoStep = img.pitch;
 		if (flipping & Image::FLIP_V) {
 			inStep = -inStep;
-			xp = img->w - 1;
+			xp = img.w - 1;
 		}
 
 		if (flipping & Image::FLIP_H) {
 			inoStep = -inoStep;
-			yp = img->h - 1;
+			yp = img.h - 1;
 		}
 
-		byte *ino = (byte *)img->getBasePtr(xp, yp);
+		const byte *ino = (const byte *)img.getBasePtr(xp, yp);
 		byte *outo = (byte *)_backSurface->getBasePtr(posX, posY);
-		byte *in, *out;
-
-		for (int i = 0; i < img->h; i++) {
-			out = outo;
-			in = ino;
-			for (int j = 0; j < img->w; j++) {
-				uint32 pix = *(uint32 *)in;
-				int b = (pix >> 0) & 0xff;
-				int g = (pix >> 8) & 0xff;
-				int r = (pix >> 16) & 0xff;
-				int a = (pix >> 24) & 0xff;
-				in += inStep;
-
-				if (ca != 255) {
-					a = a * ca >> 8;
-				}
-
-				switch (a) {
-				case 0: // Full transparency
-					out += 4;
-					break;
-				case 255: // Full opacity
-#if defined(SCUMM_LITTLE_ENDIAN)
-					if (cb != 255)
-						*out++ = (b * cb) >> 8;
-					else
-						*out++ = b;
-
-					if (cg != 255)
-						*out++ = (g * cg) >> 8;
-					else
-						*out++ = g;
-
-					if (cr != 255)
-						*out++ = (r * cr) >> 8;
-					else
-						*out++ = r;
-
-					*out++ = a;
-#else
-					*out++ = a;
-
-					if (cr != 255)
-						*out++ = (r * cr) >> 8;
-					else
-						*out++ = r;
-
-					if (cg != 255)
-						*out++ = (g * cg) >> 8;
-					else
-						*out++ = g;
-
-					if (cb != 255)
-						*out++ = (b * cb) >> 8;
-					else
-						*out++ = b;
-#endif
-					break;
 
-				default: // alpha blending
-#if defined(SCUMM_LITTLE_ENDIAN)
-					if (cb == 0)
-						*out = 0;
-					else if (cb != 255)
-						*out += ((b - *out) * a * cb) >> 16;
-					else
-						*out += ((b - *out) * a) >> 8;
-					out++;
-					if (cg == 0)
-						*out = 0;
-					else if (cg != 255)
-						*out += ((g - *out) * a * cg) >> 16;
-					else
-						*out += ((g - *out) * a) >> 8;
-					out++;
-					if (cr == 0)
-						*out = 0;
-					else if (cr != 255)
-						*out += ((r - *out) * a * cr) >> 16;
-					else
-						*out += ((r - *out) * a) >> 8;
-					out++;
-					*out = 255;
-					out++;
-#else
-					*out = 255;
-					out++;
-					if (cr == 0)
-						*out = 0;
-					else if (cr != 255)
-						*out += ((r - *out) * a * cr) >> 16;
-					else
-						*out += ((r - *out) * a) >> 8;
-					out++;
-					if (cg == 0)
-						*out = 0;
-					else if (cg != 255)
-						*out += ((g - *out) * a * cg) >> 16;
-					else
-						*out += ((g - *out) * a) >> 8;
-					out++;
-					if (cb == 0)
-						*out = 0;
-					else if (cb != 255)
-						*out += ((b - *out) * a * cb) >> 16;
-					else
-						*out += ((b - *out) * a) >> 8;
-					out++;
-#endif
-				}
-			}
+		for (int i = 0; i < img.h; i++) {
+			blendRow(ino, inStep, outo, img.w, ca, cr, cg, cb);
 			outo += _backSurface->pitch;
 			ino += inoStep;
 		}
 
 		g_system->copyRectToScreen((byte *)_backSurface->getBasePtr(posX, posY), _backSurface->pitch, posX, posY,
-			img->w, img->h);
-	}
-
-	if (imgScaled) {
-		imgScaled->pixels = savedPixels;
-		imgScaled->free();
-		delete imgScaled;
+			img.w, img.h);
 	}
 
 	return true;
@@ -467,6 +580,54 @@ void RenderedImage::copyDirectly(int posX, int posY) {
 	g_system->copyRectToScreen(data, _backSurface->pitch, posX, posY, w, h);
 }
 
+const Graphics::Surface *RenderedImage::getScaledVariant(const Graphics::Surface &srcImage, const Common::Rect &srcRect, int width, int height) {
+	int i;
+	for (i = 0; i < kScaledVariantCount - 1; ++i) {
+		const Graphics::Surface *s = _scaledVariants[i].surface;
+		if (s && s->w == width && s->h == height && _scaledVariants[i].srcRect == srcRect)
+			break;
+	}
+
+	ScaledVariant variant = _scaledVariants[i];
+	if (!variant.surface || variant.surface->w != width || variant.surface->h != height || variant.srcRect != srcRect) {
+		// Not found, replace the least recently used one
+		if (variant.surface) {
+			variant.surface->free();
+			delete variant.surface;
+		}
+
+		variant.srcRect = srcRect;
+		variant.surface = scale(srcImage, width, height);
+	}
+
+	// Move it to the front
+	for (; i > 0; --i)
+		_scaledVariants[i] = _scaledVariants[i - 1];
+	_scaledVariants[0] = variant;
+
+	return variant.surface;
+}
+
+uint RenderedImage::getSize() const {
+	// The scaled versions are part of the memory the image takes up
+	uint size = _width * _height * 4;
+	for (int i = 0; i < kScaledVariantCount; ++i) {
+		if (_scaledVariants[i].surface)
+			size += _scaledVariants[i].surface->pitch * _scaledVariants[i].surface->h;
+	}
+	return size;
+}
+
+void RenderedImage::flushScaledVariants() {
+	for (int i = 0; i < kScaledVariantCount; ++i) {
+		if (_scaledVariants[i].surface) {
+			_scaledVariants[i].surface->free();
+			delete _scaledVariants[i].surface;
+			_scaledVariants[i].surface = 0;
+		}
+	}
+}
+
 /**
  * Scales a passed surface, creating a new surface with the result
  * @param srcImage		Source image to scale
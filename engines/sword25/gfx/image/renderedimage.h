@@ -65,6 +65,7 @@ public:
 	virtual int getHeight() const {
 		return _height;
 	}
+	virtual uint getSize() const;
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
@@ -106,6 +107,18 @@ public:
 	static Graphics::Surface *scale(const Graphics::Surface &srcImage, int xSize, int ySize);
 
 private:
+	enum {
+		/** Number of scaled versions of the image which are kept around */
+		kScaledVariantCount = 2
+	};
+
+	struct ScaledVariant {
+		Common::Rect srcRect;           ///< The part of the image which was scaled
+		Graphics::Surface *surface;     ///< The scaled image, or NULL
+
+		ScaledVariant() : surface(0) {}
+	};
+
 	byte *_data;
 	int  _width;
 	int  _height;
@@ -113,6 +126,19 @@ private:
 
 	Graphics::Surface *_backSurface;
 
+	/** The scaled versions of the image, most recently used first */
+	ScaledVariant _scaledVariants[kScaledVariantCount];
+
+	/**
+	 * Returns a part of the image scaled to the given size. Scaled images
+	 * are kept, as an image is usually drawn at the same size for many
+	 * frames in a row.
+	 */
+	const Graphics::Surface *getScaledVariant(const Graphics::Surface &srcImage, const Common::Rect &srcRect, int width, int height);
+
+	/** Frees the scaled versions of the image, when its content changes */
+	void flushScaledVariants();
+
 	static int *scaleLine(int size, int srcSize);
 };
 
@@ -46,6 +46,14 @@ namespace Sword25 {
 // are loaded, the resource manager will start purging resources till it
 // hits the minimum limit above
 #define SWORD25_RESOURCECACHE_MAX 500
+// The number of bytes the decoded resources may take up. Above that, the
+// resource manager purges unlocked resources till it gets below the lower
+// limit. Most of this are the 32 bit images of animation frames, each of
+// them easily taking up a megabyte.
+#define SWORD25_RESOURCECACHE_MEMORY_MIN (96 * 1024 * 1024)
+#define SWORD25_RESOURCECACHE_MEMORY_MAX (128 * 1024 * 1024)
+// The maximum number of remembered unique file names
+#define SWORD25_UNIQUEFILENAMES_MAX 4096
 
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
@@ -87,9 +95,12 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  */
 void ResourceManager::deleteResourcesIfNecessary() {
 	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	const bool tooManyResources = (_resources.size() >= SWORD25_RESOURCECACHE_MAX);
+	if (!tooManyResources && _usedMemory < SWORD25_RESOURCECACHE_MEMORY_MAX)
 		return;
 
+	debugC(kDebugResource, "Purging resource cache: %u resources, %u bytes", _resources.size(), _usedMemory);
+
 	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
 	// The list is processed backwards in order to first release those resources that have been
 	// not been accessed for the longest
@@ -100,14 +111,16 @@ void ResourceManager::deleteResourcesIfNecessary() {
 		// The resource may be released only if it isn't locked
 		if ((*iter)->getLockCount() == 0)
 			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	} while (iter != _resources.begin() &&
+	         (_resources.size() >= SWORD25_RESOURCECACHE_MIN || _usedMemory >= SWORD25_RESOURCECACHE_MEMORY_MIN));
 
 	// Are we still above the minimum? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
-	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	// any impact on the game itself. Locked resources are in use, so they
+	// are not unlocked just because of the memory they take up.
+	if (!tooManyResources || _resources.size() <= SWORD25_RESOURCECACHE_MIN)
 		return;
 
 	iter = _resources.end();
@@ -176,6 +189,7 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 		pResource = loadResource(uniqueFileName);
 	if (pResource) {
 		moveToFront(pResource);
+		updateUsedMemory(pResource);
 		(pResource)->addReference();
 		return pResource;
 	}
@@ -233,6 +247,19 @@ void ResourceManager::moveToFront(Resource *pResource) {
 	pResource->_iterator = _resources.begin();
 }
 
+/**
+ * Accounts for the current size of a resource, which may have changed since
+ * it was loaded, e.g. because an image keeps scaled copies of itself
+ * @param pResource     The resource
+ */
+void ResourceManager::updateUsedMemory(Resource *pResource) {
+	// The size is kept, so that exactly the same amount is subtracted again
+	// when the resource is deleted
+	const uint size = pResource->getSize();
+	_usedMemory = _usedMemory - pResource->_size + size;
+	pResource->_size = size;
+}
+
 /**
  * Loads a resource and updates the m_UsedMemory total
  *
@@ -257,6 +284,9 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			_resources.push_front(pResource);
 			pResource->_iterator = _resources.begin();
 
+			// Account for its memory
+			updateUsedMemory(pResource);
+
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
@@ -273,7 +303,7 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
  * Returns the full path of a given resource filename.
  * It will return an empty string if a path could not be created.
 */
-Common::String ResourceManager::getUniqueFileName(const Common::String &fileName) const {
+Common::String ResourceManager::getUniqueFileName(const Common::String &fileName) {
 	// Get a pointer to the package manager
 	PackageManager *pPackage = (PackageManager *)_kernelPtr->getPackage();
 	if (!pPackage) {
@@ -281,11 +311,25 @@ Common::String ResourceManager::getUniqueFileName(const Common::String &fileName
 		return Common::String();
 	}
 
+	// Relative file names depend on the current directory, so the remembered
+	// names are only valid as long as it stays the same
+	if (_uniqueFileNamesDirectory != pPackage->getCurrentDirectory() ||
+		_uniqueFileNames.size() >= SWORD25_UNIQUEFILENAMES_MAX) {
+		_uniqueFileNames.clear();
+		_uniqueFileNamesDirectory = pPackage->getCurrentDirectory();
+	}
+
+	UniqueFileNameMap::const_iterator it = _uniqueFileNames.find(fileName);
+	if (it != _uniqueFileNames.end())
+		return it->_value;
+
 	// Absoluten Pfad der Datei bekommen und somit die Eindeutigkeit des Dateinamens sicherstellen
 	Common::String uniquefileName = pPackage->getAbsolutePath(fileName);
 	if (uniquefileName.empty())
 		error("Could not create absolute file name for \"%s\".", fileName.c_str());
 
+	_uniqueFileNames[fileName] = uniquefileName;
+
 	return uniquefileName;
 }
 
@@ -296,6 +340,8 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
+	_usedMemory -= pResource->_size;
+
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
@@ -88,13 +88,21 @@ public:
 	 */
 	void dumpLockedResources();
 
+	/**
+	 * Returns the number of bytes taken up by the loaded resources
+	 */
+	uint getUsedMemory() const {
+		return _usedMemory;
+	}
+
 private:
 	/**
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
 	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
+		_kernelPtr(pKernel),
+		_usedMemory(0)
 	{}
 	virtual ~ResourceManager();
 
@@ -104,6 +112,12 @@ private:
 	 */
 	void moveToFront(Resource *pResource);
 
+	/**
+	 * Accounts for the current size of a resource, which may have changed since it was loaded
+	 * @param pResource     The resource
+	 */
+	void updateUsedMemory(Resource *pResource);
+
 	/**
 	 * Loads a resource and updates the m_UsedMemory total
 	 *
@@ -115,8 +129,9 @@ private:
 	/**
 	 * Returns the full path of a given resource filename.
 	 * It will return an empty string if a path could not be created.
+	 * The result is remembered until the current directory changes.
 	*/
-	Common::String getUniqueFileName(const Common::String &fileName) const;
+	Common::String getUniqueFileName(const Common::String &fileName);
 
 	/**
 	 * Deletes a resource, removes it from the lists, and updates m_UsedMemory
@@ -139,6 +154,11 @@ private:
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
+	uint _usedMemory;
+
+	typedef Common::HashMap<Common::String, Common::String> UniqueFileNameMap;
+	UniqueFileNameMap _uniqueFileNames;
+	Common::String _uniqueFileNamesDirectory;    ///< The current directory the unique file names belong to
 };
 
 } // End of namespace Sword25
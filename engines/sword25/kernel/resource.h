@@ -92,6 +92,14 @@ public:
 		return _type;
 	}
 
+	/**
+	 * Returns the number of bytes the decoded resource occupies in memory.
+	 * Small resources which only hold a description of other ones return 0.
+	 */
+	virtual uint getSize() const {
+		return 0;
+	}
+
 protected:
 	virtual ~Resource() {}
 
@@ -99,6 +107,7 @@ private:
 	Common::String _fileName;          ///< The absolute filename
 	uint _refCount;          ///< The number of locks
 	uint _type;              ///< The type of the resource
+	uint _size;              ///< The size accounted for in the resource manager
 	Common::List<Resource *>::iterator _iterator;        ///< Points to the resource position in the LRU list
 };
 
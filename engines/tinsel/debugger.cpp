@@ -28,6 +28,7 @@
 #include "tinsel/sound.h"
 #include "tinsel/music.h"
 #include "tinsel/font.h"
+#include "tinsel/heapmem.h"
 #include "tinsel/strres.h"
 
 namespace Tinsel {
@@ -67,6 +68,7 @@ Console::Console() : GUI::Debugger() {
 	DCmd_Register("music",		WRAP_METHOD(Console, cmd_music));
 	DCmd_Register("sound",		WRAP_METHOD(Console, cmd_sound));
 	DCmd_Register("string",		WRAP_METHOD(Console, cmd_string));
+	DCmd_Register("heap",		WRAP_METHOD(Console, cmd_heap));
 }
 
 Console::~Console() {
@@ -161,4 +163,24 @@ bool Console::cmd_string(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmd_heap(int argc, const char **argv) {
+	if (argc != 1) {
+		DebugPrintf("%s\n", argv[0]);
+		DebugPrintf("Shows the heap usage and how much time was spent making room in it\n");
+		return true;
+	}
+
+	HEAP_STATS stats;
+	MemoryGetStats(stats);
+
+	const long used = stats.heapSize - stats.freeSize;
+	DebugPrintf("%ld of %u bytes used in %d blocks, largest block %u bytes, %d blocks discarded\n",
+		used, stats.heapSize, stats.numBlocks, stats.largestBlock, stats.numDiscarded);
+	DebugPrintf("Made room %u times, discarding %u blocks, in %u ms (longest %u ms)\n",
+		stats.compactions, stats.compactDiscards, stats.totalPause, stats.maxPause);
+	DebugPrintf("Discarded %u unused blocks in advance\n", stats.idleDiscards);
+
+	return true;
+}
+
 } // End of namespace Tinsel
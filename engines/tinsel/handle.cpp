@@ -345,11 +345,11 @@ byte *LockMem(SCNHANDLE offset) {
 			MemoryReAlloc(pH->_node, g_cdTopHandle - g_cdBaseHandle);
 
 			LoadCDGraphData(pH);
-
-			// update the LRU time (new in this file)
-			MemoryTouch(pH->_node);
 		}
 
+		// update the LRU time, so that data in use is not discarded
+		MemoryTouch(pH->_node);
+
 		// make sure address is valid
 		assert(pH->filesize & fLoaded);
 
@@ -366,6 +366,9 @@ byte *LockMem(SCNHANDLE offset) {
 			LoadFile(pH);
 		}
 
+		// update the LRU time, so that data in use is not discarded
+		MemoryTouch(pH->_node);
+
 		// make sure address is valid
 		assert(pH->filesize & fLoaded);
 	}
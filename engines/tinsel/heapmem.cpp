@@ -25,11 +25,20 @@
 #include "tinsel/timers.h"	// For DwGetCurrentTime
 #include "tinsel/tinsel.h"
 
+#include "common/algorithm.h"
+
 namespace Tinsel {
 
 
 #define	NUM_MNODES	192	// the number of memory management nodes (was 128, then 192)
 
+// MemoryIdle() starts discarding blocks once less than this part of the heap is free
+#define	IDLE_FREE_DIVISOR	8
+
+// and only discards blocks which were not used for this long (DwGetCurrentTime()
+// runs at 55 ticks a second)
+#define	IDLE_DISCARD_AGE	(5 * 55)
+
 
 // internal allocation flags
 #define	DWM_USED		0x0001	///< the objects memory block is in use
@@ -69,6 +78,12 @@ MEM_NODE g_s_fixedMnodesList[5];
 // the mnode heap sentinel
 static MEM_NODE g_heapSentinel;
 
+// the size of the whole heap
+static uint32 g_heapTotalSize;
+
+// statistics of the heap compaction
+static HEAP_STATS g_heapStats;
+
 //
 static MEM_NODE *AllocMemNode();
 
@@ -130,6 +145,9 @@ void MemoryInit() {
 	if (TinselVersion == TINSEL_V1) size = MemoryPoolSize[1];
 	else if (TinselVersion == TINSEL_V2) size = MemoryPoolSize[2];
 	g_heapSentinel.size = size;
+	g_heapTotalSize = size;
+
+	memset(&g_heapStats, 0, sizeof(g_heapStats));
 }
 
 /**
@@ -188,6 +206,10 @@ void FreeMemNode(MEM_NODE *pMemNode) {
 }
 
 
+static bool LruTimeLess(const MEM_NODE *a, const MEM_NODE *b) {
+	return a->lruTime < b->lruTime;
+}
+
 /**
  * Tries to make space for the specified number of bytes on the specified heap.
  * @param size			Number of bytes to free up
@@ -195,34 +217,90 @@ void FreeMemNode(MEM_NODE *pMemNode) {
  */
 static bool HeapCompact(long size) {
 	const MEM_NODE *pHeap = &g_heapSentinel;
-	MEM_NODE *pCur, *pOldest;
-	uint32 oldest;		// time of the oldest discardable block
-
-	while (g_heapSentinel.size < size) {
-
-		// find the oldest discardable block
-		oldest = DwGetCurrentTime();
-		pOldest = NULL;
-		for (pCur = pHeap->pNext; pCur != pHeap; pCur = pCur->pNext) {
-			if (pCur->flags == DWM_USED) {
-				// found a non-discarded discardable block
-				if (pCur->lruTime < oldest) {
-					oldest = pCur->lruTime;
-					pOldest = pCur;
-				}
-			}
+	MEM_NODE *pCur;
+
+	if (g_heapSentinel.size >= size)
+		return true;
+
+	const uint32 startTime = g_system->getMillis();
+
+	// collect the non-discarded discardable blocks, not counting the ones
+	// allocated just now, and discard them oldest first
+	MEM_NODE *candidates[NUM_MNODES];
+	int numCandidates = 0;
+	const uint32 now = DwGetCurrentTime();
+
+	for (pCur = pHeap->pNext; pCur != pHeap; pCur = pCur->pNext) {
+		if (pCur->flags == DWM_USED && pCur->lruTime < now)
+			candidates[numCandidates++] = pCur;
+	}
+
+	Common::sort(candidates, candidates + numCandidates, LruTimeLess);
+
+	int i = 0;
+	while (g_heapSentinel.size < size && i < numCandidates)
+		MemoryDiscard(candidates[i++]);
+
+	const uint32 pause = g_system->getMillis() - startTime;
+	g_heapStats.compactions++;
+	g_heapStats.compactDiscards += i;
+	g_heapStats.totalPause += pause;
+	g_heapStats.maxPause = MAX(g_heapStats.maxPause, pause);
+
+	// did we free enough memory?
+	return g_heapSentinel.size >= size;
+}
+
+/**
+ * Discards the least recently used block, if the heap is getting full and
+ * the block has not been used for a while. Called once per game cycle, so
+ * that HeapCompact() rarely has to discard a lot of blocks at once when
+ * a scene is loaded.
+ */
+void MemoryIdle() {
+	if (g_heapSentinel.size >= (long)(g_heapTotalSize / IDLE_FREE_DIVISOR))
+		return;
+
+	const MEM_NODE *pHeap = &g_heapSentinel;
+	MEM_NODE *pCur, *pOldest = NULL;
+	const uint32 now = DwGetCurrentTime();
+
+	for (pCur = pHeap->pNext; pCur != pHeap; pCur = pCur->pNext) {
+		if (pCur->flags == DWM_USED && pCur->lruTime + IDLE_DISCARD_AGE < now) {
+			if (!pOldest || pCur->lruTime < pOldest->lruTime)
+				pOldest = pCur;
 		}
+	}
 
-		if (pOldest)
-			// discard the oldest block
-			MemoryDiscard(pOldest);
-		else
-			// cannot discard any blocks
-			return false;
+	if (pOldest) {
+		MemoryDiscard(pOldest);
+		g_heapStats.idleDiscards++;
 	}
+}
+
+/**
+ * Returns the current usage of the heap, and the statistics of the
+ * compaction.
+ */
+void MemoryGetStats(HEAP_STATS &stats) {
+	const MEM_NODE *pHeap = &g_heapSentinel;
+	const MEM_NODE *pCur;
 
-	// we have freed enough memory
-	return true;
+	stats = g_heapStats;
+	stats.heapSize = g_heapTotalSize;
+	stats.freeSize = g_heapSentinel.size;
+	stats.numBlocks = 0;
+	stats.numDiscarded = 0;
+	stats.largestBlock = 0;
+
+	for (pCur = pHeap->pNext; pCur != pHeap; pCur = pCur->pNext) {
+		if (pCur->flags & DWM_DISCARDED) {
+			stats.numDiscarded++;
+		} else {
+			stats.numBlocks++;
+			stats.largestBlock = MAX<uint32>(stats.largestBlock, pCur->size);
+		}
+	}
 }
 
 /**
@@ -63,6 +63,25 @@ void MemoryTouch(MEM_NODE *pMemNode);
 // Dereference a given memory node
 uint8 *MemoryDeref(MEM_NODE *pMemNode);
 
+// discards an unused block if the heap is getting full, called once per game cycle
+void MemoryIdle();
+
+// heap usage and compaction statistics
+struct HEAP_STATS {
+	uint32 heapSize;		// size of the whole heap
+	long freeSize;			// bytes not allocated
+	int numBlocks;			// number of allocated blocks
+	int numDiscarded;		// number of discarded blocks, which may be reloaded
+	uint32 largestBlock;	// size of the largest allocated block
+	uint32 compactions;		// number of times an allocation had to make room
+	uint32 compactDiscards;	// blocks discarded to make room
+	uint32 idleDiscards;	// blocks discarded by MemoryIdle()
+	uint32 maxPause;		// longest time spent making room, in ms
+	uint32 totalPause;		// total time spent making room, in ms
+};
+
+void MemoryGetStats(HEAP_STATS &stats);
+
 } // End of namespace Tinsel
 
 #endif
@@ -971,6 +971,9 @@ Common::Error TinselEngine::run() {
 			timerVal = g_system->getMillis();
 			_system->getAudioCDManager()->updateCD();
 			NextGameCycle();
+
+			// Make room for the next scene while nothing much happens
+			MemoryIdle();
 		}
 
 		if (g_bRestart) {
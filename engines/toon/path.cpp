@@ -152,6 +152,8 @@ PathFinding::PathFinding(ToonEngine *vm) : _vm(vm) {
 	_heap = new PathFindingHeap();
 	_gridTemp = NULL;
 	_numBlockingRects = 0;
+	_pathCacheCount = 0;
+	_pathCacheNext = 0;
 }
 
 PathFinding::~PathFinding(void) {
@@ -197,15 +199,42 @@ int32 PathFinding::findClosestWalkingPoint(int32 xx, int32 yy, int32 *fxx, int32
 	if (origY == -1)
 		origY = yy;
 
-	for (int y = 0; y < _height; y++) {
-		for (int x = 0; x < _width; x++) {
-			if (isWalkable(x, y) && isLikelyWalkable(x, y)) {
-				int32 ndist = (x - xx) * (x - xx) + (y - yy) * (y - yy);
-				int32 ndist2 = (x - origX) * (x - origX) + (y - origY) * (y - origY);
-				if (currentFound < 0 || ndist < dist || (ndist == dist && ndist2 < dist2)) {
-					dist = ndist;
-					dist2 = ndist2;
-					currentFound = y * _width + x;
+	// Look at squares of growing size around the wanted point, until no
+	// point on the next one can be closer than the best one found so far.
+	// Points at the same distance are compared the way a scan of the
+	// whole mask, line by line, would find them.
+	const int32 maxRadius = MAX(MAX<int32>(abs(xx), abs(xx - _width + 1)), MAX<int32>(abs(yy), abs(yy - _height + 1)));
+
+	for (int32 r = 0; r <= maxRadius; r++) {
+		if (currentFound >= 0 && r * r > dist)
+			break;
+
+		const int32 startY = MAX<int32>(yy - r, 0);
+		const int32 endY = MIN<int32>(yy + r, _height - 1);
+
+		for (int32 y = startY; y <= endY; y++) {
+			// the top and bottom line of the square are taken whole,
+			// only the left and right end of the others
+			const bool wholeLine = (y == yy - r || y == yy + r);
+			const int32 startX = MAX<int32>(xx - r, 0);
+			const int32 endX = MIN<int32>(xx + r, _width - 1);
+
+			for (int32 x = startX; x <= endX; x++) {
+				if (!wholeLine && x > xx - r && x < xx + r) {
+					x = xx + r;
+					if (x > endX)
+						break;
+				}
+
+				if (isWalkable(x, y) && isLikelyWalkable(x, y)) {
+					int32 ndist = (x - xx) * (x - xx) + (y - yy) * (y - yy);
+					int32 ndist2 = (x - origX) * (x - origX) + (y - origY) * (y - origY);
+					int32 node = y * _width + x;
+					if (currentFound < 0 || ndist < dist || (ndist == dist && (ndist2 < dist2 || (ndist2 == dist2 && node < currentFound)))) {
+						dist = ndist;
+						dist2 = ndist2;
+						currentFound = node;
+					}
 				}
 			}
 		}
@@ -301,8 +330,16 @@ int32 PathFinding::findPath(int32 x, int32 y, int32 destx, int32 desty) {
 		return true;
 	}
 
+	bool found;
+	if (lookupCachedPath(x, y, destx, desty, &found))
+		return found;
+
 	// no direct line, we use the standard A* algorithm
-	memset(_gridTemp , 0, _width * _height * sizeof(int32));
+	// only the nodes the last search reached need to be cleared
+	for (uint i = 0; i < _gridTempUsed.size(); i++)
+		_gridTemp[_gridTempUsed[i]] = 0;
+	_gridTempUsed.clear();
+
 	_heap->clear();
 	int32 curX = x;
 	int32 curY = y;
@@ -310,6 +347,7 @@ int32 PathFinding::findPath(int32 x, int32 y, int32 destx, int32 desty) {
 	int32 *sq = _gridTemp;
 
 	sq[curX + curY *_width] = 1;
+	_gridTempUsed.push_back(curX + curY * _width);
 	_heap->push(curX, curY, abs(destx - x) + abs(desty - y));
 	int wei = 0;
 
@@ -318,6 +356,11 @@ int32 PathFinding::findPath(int32 x, int32 y, int32 destx, int32 desty) {
 		_heap->pop(&curX, &curY, &curWeight);
 		int curNode = curX + curY * _width;
 
+		// The distance to the destination never overestimates the cost
+		// of getting there, so once it comes up, no shorter way is left
+		if (curX == destx && curY == desty)
+			break;
+
 		int32 endX = MIN<int32>(curX + 1, _width - 1);
 		int32 endY = MIN<int32>(curY + 1, _height - 1);
 		int32 startX = MAX<int32>(curX - 1, 0);
@@ -334,6 +377,8 @@ int32 PathFinding::findPath(int32 x, int32 y, int32 destx, int32 desty) {
 						int sum = sq[curNode] + wei * (1 + (isLikelyWalkable(px, py) ? 5 : 0));
 						if (sq[curPNode] > sum || !sq[curPNode]) {
 							int newWeight = abs(destx - px) + abs(desty - py);
+							if (!sq[curPNode])
+								_gridTempUsed.push_back(curPNode);
 							sq[curPNode] = sum;
 							_heap->push(px, py, sq[curPNode] + newWeight);
 							if (!newWeight)
@@ -349,6 +394,7 @@ int32 PathFinding::findPath(int32 x, int32 y, int32 destx, int32 desty) {
 	if (!_gridTemp[destx + desty * _width]) {
 		// didn't find anything
 		_gridPathCount = 0;
+		storeCachedPath(x, y, destx, desty, false);
 		return false;
 	}
 
@@ -417,6 +463,7 @@ int32 PathFinding::findPath(int32 x, int32 y, int32 destx, int32 desty) {
 			free(retPathX);
 			free(retPathY);
 
+			storeCachedPath(x, y, destx, desty, true);
 			return true;
 		}
 
@@ -440,6 +487,62 @@ void PathFinding::init(Picture *mask) {
 	_heap->init(500);
 	delete[] _gridTemp;
 	_gridTemp = new int32[_width*_height];
+	memset(_gridTemp, 0, _width * _height * sizeof(int32));
+	_gridTempUsed.clear();
+
+	// the cached paths were found on the previous mask
+	invalidateCache();
+}
+
+void PathFinding::invalidateCache() {
+	_pathCacheCount = 0;
+	_pathCacheNext = 0;
+}
+
+bool PathFinding::lookupCachedPath(int32 x, int32 y, int32 destX, int32 destY, bool *found) {
+	for (int32 i = 0; i < _pathCacheCount; i++) {
+		const CachedPath &path = _pathCache[i];
+		if (path._x != x || path._y != y || path._destX != destX || path._destY != destY)
+			continue;
+
+		// the blocking rects change the cost of the nodes, so the
+		// path only applies as long as they stay the same
+		if (path._numBlockingRects != _numBlockingRects ||
+		    memcmp(path._blockingRects, _blockingRects, sizeof(_blockingRects[0]) * _numBlockingRects))
+			continue;
+
+		debugC(1, kDebugPath, "findPath: using cached path");
+
+		*found = path._found;
+		_gridPathCount = path._pathX.size();
+		for (int32 j = 0; j < _gridPathCount; j++) {
+			_tempPathX[j] = path._pathX[j];
+			_tempPathY[j] = path._pathY[j];
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void PathFinding::storeCachedPath(int32 x, int32 y, int32 destX, int32 destY, bool found) {
+	CachedPath &path = _pathCache[_pathCacheNext];
+	_pathCacheNext = (_pathCacheNext + 1) % kPathCacheSize;
+	_pathCacheCount = MAX<int32>(_pathCacheCount, _pathCacheNext == 0 ? kPathCacheSize : _pathCacheNext);
+
+	path._x = x;
+	path._y = y;
+	path._destX = destX;
+	path._destY = destY;
+	path._numBlockingRects = _numBlockingRects;
+	memcpy(path._blockingRects, _blockingRects, sizeof(_blockingRects[0]) * _numBlockingRects);
+	path._found = found;
+	path._pathX.resize(_gridPathCount);
+	path._pathY.resize(_gridPathCount);
+	for (int32 i = 0; i < _gridPathCount; i++) {
+		path._pathX[i] = _tempPathX[i];
+		path._pathY[i] = _tempPathY[i];
+	}
 }
 
 void PathFinding::resetBlockingRects() {
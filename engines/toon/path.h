@@ -23,6 +23,8 @@
 #ifndef TOON_PATH_H
 #define TOON_PATH_H
 
+#include "common/array.h"
+
 #include "toon/toon.h"
 
 namespace Toon {
@@ -64,6 +66,7 @@ public:
 	bool lineIsWalkable(int32 x, int32 y, int32 x2, int32 y2);
 	bool walkLine(int32 x, int32 y, int32 x2, int32 y2);
 	void init(Picture *mask);
+	void invalidateCache(); // must be called whenever the mask changes
 
 	void resetBlockingRects();
 	void addBlockingRect(int32 x1, int32 y1, int32 x2, int32 y2);
@@ -73,11 +76,32 @@ public:
 	int32 getPathNodeX(int32 nodeId) const;
 	int32 getPathNodeY(int32 nodeId) const;
 protected:
+	enum {
+		kPathCacheSize = 8
+	};
+
+	// a path found by the A* search, along with everything it depends on
+	struct CachedPath {
+		int32 _x, _y, _destX, _destY;
+		int32 _numBlockingRects;
+		int32 _blockingRects[16][5];
+		bool _found;
+		Common::Array<int32> _pathX, _pathY;
+	};
+
+	bool lookupCachedPath(int32 x, int32 y, int32 destX, int32 destY, bool *found);
+	void storeCachedPath(int32 x, int32 y, int32 destX, int32 destY, bool found);
+
 	Picture *_currentMask;
 
 	PathFindingHeap *_heap;
 
 	int32 *_gridTemp;
+	Common::Array<int32> _gridTempUsed;
+
+	CachedPath _pathCache[kPathCacheSize];
+	int32 _pathCacheCount;
+	int32 _pathCacheNext;
 	int32 _width;
 	int32 _height;
 
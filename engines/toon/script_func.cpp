@@ -31,6 +31,7 @@
 #include "toon/hotspot.h"
 #include "toon/drew.h"
 #include "toon/flux.h"
+#include "toon/path.h"
 
 namespace Toon {
 
@@ -588,6 +589,7 @@ int32 ScriptFunc::sys_Cmd_Set_Scroll_Lock(EMCState *state) {
 
 int32 ScriptFunc::sys_Cmd_Fill_Area_Non_Walkable(EMCState *state) {
 	_vm->getMask()->floodFillNotWalkableOnMask(stackPos(0), stackPos(1));
+	_vm->getPathFinding()->invalidateCache();
 
 	// we have to store some info for savegame
 	_vm->getSaveBufferStream()->writeSint16BE(4); // 4 = sys_Cmd_Make_Line_Walkable
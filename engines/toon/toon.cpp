@@ -3195,6 +3195,7 @@ bool ToonEngine::loadGame(int32 slot) {
 				int16 x = rStr.readSint16BE();
 				int16 y = rStr.readSint16BE();
 				getMask()->floodFillNotWalkableOnMask(x, y);
+				_pathFinding->invalidateCache();
 				break;
 			}
 			default:
@@ -4636,10 +4637,12 @@ void ToonEngine::unloadTextsVariants(char **texts) {
 
 void ToonEngine::makeLineNonWalkable(int32 x, int32 y, int32 x2, int32 y2) {
 	_currentMask->drawLineOnMask(x, y, x2, y2, false);
+	_pathFinding->invalidateCache();
 }
 
 void ToonEngine::makeLineWalkable(int32 x, int32 y, int32 x2, int32 y2) {
 	_currentMask->drawLineOnMask(x, y, x2, y2, true);
+	_pathFinding->invalidateCache();
 }
 
 void ToonEngine::playRoomMusic() {
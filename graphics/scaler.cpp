@@ -21,6 +21,7 @@
  */
 
 #include "graphics/scaler/intern.h"
+#include "graphics/scaler/hqpattern.h"
 #include "graphics/scaler/scalebit.h"
 #include "common/util.h"
 #include "common/system.h"
@@ -142,6 +143,7 @@ void InitScalers(uint32 BitFormat) {
 
 #ifdef USE_HQ_SCALERS
 	InitLUT(format);
+	InitHQPatterns();
 #endif
 
 	// Build dotmatrix lookup table for the DotMatrix scaler.
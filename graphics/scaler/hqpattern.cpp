@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/hqpattern.h"
+#include "graphics/scaler/intern.h"
+
+#if defined(USE_HQ_PATTERN_AVX2)
+#include <immintrin.h>
+#elif defined(USE_HQ_PATTERN_SSE2)
+#include <emmintrin.h>
+#endif
+
+HQPatternProc *g_hqPatternProc = 0;
+
+static inline byte patternC(const uint32 *above, const uint32 *row, const uint32 *below) {
+	const int yuv5 = row[1];
+	byte pattern = 0;
+
+	if (diffYUV(yuv5, above[0])) pattern |= 0x0001;
+	if (diffYUV(yuv5, above[1])) pattern |= 0x0002;
+	if (diffYUV(yuv5, above[2])) pattern |= 0x0004;
+	if (diffYUV(yuv5, row[0]))   pattern |= 0x0008;
+	if (diffYUV(yuv5, row[2]))   pattern |= 0x0010;
+	if (diffYUV(yuv5, below[0])) pattern |= 0x0020;
+	if (diffYUV(yuv5, below[1])) pattern |= 0x0040;
+	if (diffYUV(yuv5, below[2])) pattern |= 0x0080;
+
+	return pattern;
+}
+
+void HQPatternsC(const uint32 *yuvAbove, const uint32 *yuvRow, const uint32 *yuvBelow, int width, byte *patterns) {
+	for (int x = 0; x < width; ++x)
+		patterns[x] = patternC(yuvAbove + x, yuvRow + x, yuvBelow + x);
+}
+
+// Both versions below check 4 resp. 8 pixels against one neighbour at
+// a time, exactly like diffYUV() does: each of the Y, U and V components
+// is masked out in place, and the absolute difference compared against
+// the threshold for that component.
+
+#ifdef USE_HQ_PATTERN_SSE2
+
+#ifdef __SSE2__
+#define TARGET_SSE2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+
+TARGET_SSE2
+static inline __m128i absDiffAbove_SSE2(__m128i a, __m128i b, __m128i mask, __m128i threshold) {
+	__m128i diff = _mm_sub_epi32(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+	const __m128i sign = _mm_srai_epi32(diff, 31);
+	diff = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+	return _mm_cmpgt_epi32(diff, threshold);
+}
+
+TARGET_SSE2
+static inline __m128i diffYUV_SSE2(__m128i yuv1, const uint32 *yuv2) {
+	const __m128i b = _mm_loadu_si128((const __m128i *)yuv2);
+
+	return _mm_or_si128(absDiffAbove_SSE2(yuv1, b, _mm_set1_epi32(0x00FF0000), _mm_set1_epi32(0x00300000)),
+	       _mm_or_si128(absDiffAbove_SSE2(yuv1, b, _mm_set1_epi32(0x0000FF00), _mm_set1_epi32(0x00000700)),
+	                    absDiffAbove_SSE2(yuv1, b, _mm_set1_epi32(0x000000FF), _mm_set1_epi32(0x00000006))));
+}
+
+TARGET_SSE2
+void HQPatternsSSE2(const uint32 *yuvAbove, const uint32 *yuvRow, const uint32 *yuvBelow, int width, byte *patterns) {
+	int x = 0;
+
+	for (; x + 4 <= width; x += 4) {
+		const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(yuvRow + x + 1));
+
+		__m128i pattern =   _mm_and_si128(diffYUV_SSE2(yuv5, yuvAbove + x),     _mm_set1_epi32(0x0001));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvAbove + x + 1), _mm_set1_epi32(0x0002)));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvAbove + x + 2), _mm_set1_epi32(0x0004)));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvRow + x),       _mm_set1_epi32(0x0008)));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvRow + x + 2),   _mm_set1_epi32(0x0010)));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvBelow + x),     _mm_set1_epi32(0x0020)));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvBelow + x + 1), _mm_set1_epi32(0x0040)));
+		pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV_SSE2(yuv5, yuvBelow + x + 2), _mm_set1_epi32(0x0080)));
+
+		// All values fit into a byte, so no saturation happens here
+		pattern = _mm_packs_epi32(pattern, pattern);
+		pattern = _mm_packus_epi16(pattern, pattern);
+		const uint32 packed = _mm_cvtsi128_si32(pattern);
+		memcpy(patterns + x, &packed, 4);
+	}
+
+	for (; x < width; ++x)
+		patterns[x] = patternC(yuvAbove + x, yuvRow + x, yuvBelow + x);
+}
+
+#endif // #ifdef USE_HQ_PATTERN_SSE2
+
+#ifdef USE_HQ_PATTERN_AVX2
+
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+TARGET_AVX2
+static inline __m256i absDiffAbove_AVX2(__m256i a, __m256i b, __m256i mask, __m256i threshold) {
+	const __m256i diff = _mm256_sub_epi32(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+	return _mm256_cmpgt_epi32(_mm256_abs_epi32(diff), threshold);
+}
+
+TARGET_AVX2
+static inline __m256i diffYUV_AVX2(__m256i yuv1, const uint32 *yuv2) {
+	const __m256i b = _mm256_loadu_si256((const __m256i *)yuv2);
+
+	return _mm256_or_si256(absDiffAbove_AVX2(yuv1, b, _mm256_set1_epi32(0x00FF0000), _mm256_set1_epi32(0x00300000)),
+	       _mm256_or_si256(absDiffAbove_AVX2(yuv1, b, _mm256_set1_epi32(0x0000FF00), _mm256_set1_epi32(0x00000700)),
+	                       absDiffAbove_AVX2(yuv1, b, _mm256_set1_epi32(0x000000FF), _mm256_set1_epi32(0x00000006))));
+}
+
+TARGET_AVX2
+void HQPatternsAVX2(const uint32 *yuvAbove, const uint32 *yuvRow, const uint32 *yuvBelow, int width, byte *patterns) {
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8) {
+		const __m256i yuv5 = _mm256_loadu_si256((const __m256i *)(yuvRow + x + 1));
+
+		__m256i pattern =      _mm256_and_si256(diffYUV_AVX2(yuv5, yuvAbove + x),     _mm256_set1_epi32(0x0001));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvAbove + x + 1), _mm256_set1_epi32(0x0002)));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvAbove + x + 2), _mm256_set1_epi32(0x0004)));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvRow + x),       _mm256_set1_epi32(0x0008)));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvRow + x + 2),   _mm256_set1_epi32(0x0010)));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvBelow + x),     _mm256_set1_epi32(0x0020)));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvBelow + x + 1), _mm256_set1_epi32(0x0040)));
+		pattern = _mm256_or_si256(pattern, _mm256_and_si256(diffYUV_AVX2(yuv5, yuvBelow + x + 2), _mm256_set1_epi32(0x0080)));
+
+		// The packs work on each 128 bit half separately, which leaves
+		// pixels 0-3 in the low and pixels 4-7 in the high half
+		pattern = _mm256_packs_epi32(pattern, pattern);
+		pattern = _mm256_packus_epi16(pattern, pattern);
+		const uint32 low = _mm_cvtsi128_si32(_mm256_castsi256_si128(pattern));
+		const uint32 high = _mm_cvtsi128_si32(_mm256_extracti128_si256(pattern, 1));
+		memcpy(patterns + x, &low, 4);
+		memcpy(patterns + x + 4, &high, 4);
+	}
+
+	for (; x < width; ++x)
+		patterns[x] = patternC(yuvAbove + x, yuvRow + x, yuvBelow + x);
+}
+
+#endif // #ifdef USE_HQ_PATTERN_AVX2
+
+void InitHQPatterns() {
+	// Without SIMD, computing the patterns a row at a time does not gain
+	// anything over the plain HQ scalers
+	g_hqPatternProc = 0;
+
+#ifdef USE_HQ_PATTERN_SSE2
+#ifndef __SSE2__
+	if (__builtin_cpu_supports("sse2"))
+#endif
+		g_hqPatternProc = HQPatternsSSE2;
+#endif
+
+#ifdef USE_HQ_PATTERN_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		g_hqPatternProc = HQPatternsAVX2;
+#endif
+}
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQPATTERN_H
+#define GRAPHICS_SCALER_HQPATTERN_H
+
+#include "common/scummsys.h"
+
+#ifdef USE_HQ_SCALERS
+
+extern "C" uint32 *RGBtoYUV;
+
+// The SIMD versions are compiled for the target architecture as a whole
+// if it guarantees the instruction set, or else picked at runtime, which
+// needs GCC's target attribute and __builtin_cpu_supports().
+#if (defined(__i386__) || defined(__x86_64__)) && GCC_ATLEAST(4, 9)
+#define USE_HQ_PATTERN_SSE2
+#define USE_HQ_PATTERN_AVX2
+#elif defined(__SSE2__)
+#define USE_HQ_PATTERN_SSE2
+#endif
+
+/**
+ * Computes the neighbour patterns the hq scaler family uses to pick the
+ * interpolation for each pixel of a row: bit n (in the order w1, w2, w3,
+ * w4, w6, w7, w8, w9) is set if the YUV value of that neighbour differs
+ * noticeably from the one of the pixel itself (see diffYUV()).
+ *
+ * Each of the YUV arrays holds width + 2 values, starting with the pixel
+ * left of the row.
+ */
+typedef void HQPatternProc(const uint32 *yuvAbove, const uint32 *yuvRow, const uint32 *yuvBelow, int width, byte *patterns);
+
+HQPatternProc HQPatternsC;
+#ifdef USE_HQ_PATTERN_SSE2
+HQPatternProc HQPatternsSSE2;
+#endif
+#ifdef USE_HQ_PATTERN_AVX2
+HQPatternProc HQPatternsAVX2;
+#endif
+
+/**
+ * The pattern function used by HQ2x and HQ3x, or 0 if they compute the
+ * patterns pixel by pixel. Chosen by InitScalers() according to the
+ * CPU features available.
+ */
+extern HQPatternProc *g_hqPatternProc;
+
+/** Choose the fastest pattern function the CPU supports. */
+void InitHQPatterns();
+
+/**
+ * Keeps the YUV values of three consecutive source rows, so that every
+ * pixel is looked up in the (big) RGBtoYUV table only once, and computes
+ * the patterns of the middle row with g_hqPatternProc.
+ */
+class HQPatternRows {
+public:
+	enum {
+		/** Maximal number of pixels per row, wider areas have to be split. */
+		kMaxWidth = 256
+	};
+
+	HQPatternRows() : _started(false) {}
+
+	/**
+	 * Get the patterns of the row starting at p. Has to be called for
+	 * consecutive rows, top to bottom.
+	 */
+	const byte *nextRow(const uint16 *p, uint32 nextlineSrc, int width) {
+		if (!_started) {
+			convertRow(p - nextlineSrc, width, _yuv[0]);
+			convertRow(p, width, _yuv[1]);
+			_above = _yuv[0];
+			_row = _yuv[1];
+			_below = _yuv[2];
+			_started = true;
+		} else {
+			uint32 *oldAbove = _above;
+			_above = _row;
+			_row = _below;
+			_below = oldAbove;
+		}
+
+		convertRow(p + nextlineSrc, width, _below);
+		g_hqPatternProc(_above, _row, _below, width, _patterns);
+		return _patterns;
+	}
+
+private:
+	static void convertRow(const uint16 *p, int width, uint32 *yuv) {
+		for (int i = -1; i <= width; ++i)
+			*yuv++ = RGBtoYUV[p[i]];
+	}
+
+	bool _started;
+	uint32 *_above, *_row, *_below;
+	uint32 _yuv[3][kMaxWidth + 2];
+	byte _patterns[kMaxWidth];
+};
+
+#endif // #ifdef USE_HQ_SCALERS
+
+#endif
@@ -0,0 +1,187 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "common/endian.h"
+#include "common/frac.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Simple LCG so that the test data does not depend on the C library
+	static int16 nextSample(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (int16)(seed >> 16);
+	}
+
+	static Audio::AudioStream *createNoiseStream(int16 *samples, int numSamples, int rate, bool stereo) {
+		byte *data = (byte *)malloc(numSamples * 2);
+		for (int i = 0; i < numSamples; ++i)
+			WRITE_LE_UINT16(data + i * 2, samples[i]);
+
+		return Audio::makeRawStream(data, numSamples * 2, rate,
+		                            Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+	}
+
+	static void mixFrame(int16 *out, int16 out0, int16 out1, int volL, int volR, bool reverseStereo) {
+		Audio::clampedAdd(out[reverseStereo ? 1 : 0], (out0 * volL) / Audio::Mixer::kMaxMixerVolume);
+		Audio::clampedAdd(out[reverseStereo ? 0 : 1], (out1 * volR) / Audio::Mixer::kMaxMixerVolume);
+	}
+
+	/**
+	 * Computes the expected output one frame at a time, the way the
+	 * converters used to, and returns the number of frames produced.
+	 */
+	static int referenceConvert(const int16 *in, int numFrames, int inRate, int outRate, bool stereo, bool reverseStereo,
+	                            int16 *out, int outFrames, int volL, int volR) {
+		const int channels = stereo ? 2 : 1;
+		int produced = 0;
+
+		if (inRate == outRate) {
+			for (; produced < outFrames && produced < numFrames; ++produced) {
+				const int16 *f = in + produced * channels;
+				mixFrame(out + produced * 2, f[0], f[channels - 1], volL, volR, reverseStereo);
+			}
+		} else if ((inRate % outRate) == 0) {
+			const int step = inRate / outRate;
+			for (; produced < outFrames && produced * step + 1 < numFrames; ++produced) {
+				const int16 *f = in + (produced * step + 1) * channels;
+				mixFrame(out + produced * 2, f[0], f[channels - 1], volL, volR, reverseStereo);
+			}
+		} else {
+			const frac_t inc = ((uint32)inRate << FRAC_BITS) / outRate;
+			frac_t pos = FRAC_ONE;
+			int16 last0 = 0, last1 = 0, cur0 = 0, cur1 = 0;
+			int next = 0;
+
+			while (produced < outFrames) {
+				while (pos >= (frac_t)FRAC_ONE) {
+					if (next >= numFrames)
+						return produced;
+					last0 = cur0;
+					last1 = cur1;
+					cur0 = in[next * channels];
+					cur1 = in[next * channels + channels - 1];
+					++next;
+					pos -= FRAC_ONE;
+				}
+
+				const int16 out0 = (int16)(last0 + (((cur0 - last0) * pos + FRAC_HALF) >> FRAC_BITS));
+				const int16 out1 = (int16)(last1 + (((cur1 - last1) * pos + FRAC_HALF) >> FRAC_BITS));
+				mixFrame(out + produced * 2, out0, stereo ? out1 : out0, volL, volR, reverseStereo);
+				++produced;
+				pos += inc;
+			}
+		}
+
+		return produced;
+	}
+
+	void convertTestTemplate(int inRate, int outRate, bool stereo, bool reverseStereo, int volL, int volR) {
+		const int numFrames = 3000;
+		const int channels = stereo ? 2 : 1;
+		const int outFrames = numFrames * outRate / inRate + 16;
+
+		uint32 seed = inRate + outRate * 3 + volL * 7 + volR * 11 + channels;
+		int16 *in = new int16[numFrames * channels];
+		for (int i = 0; i < numFrames * channels; ++i)
+			in[i] = nextSample(seed);
+
+		// Start with some noise in the output, so that clipping kicks in
+		int16 *expected = new int16[outFrames * 2];
+		int16 *out = new int16[outFrames * 2];
+		for (int i = 0; i < outFrames * 2; ++i)
+			expected[i] = out[i] = nextSample(seed);
+
+		const int expectedFrames = referenceConvert(in, numFrames, inRate, outRate, stereo, reverseStereo,
+		                                            expected, outFrames, volL, volR);
+
+		Audio::AudioStream *input = createNoiseStream(in, numFrames * channels, inRate, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo);
+
+		// Request odd sized chunks, to cross the internal block boundaries
+		int produced = 0;
+		const int chunks[] = { 1, 7, 300, 513, 1024 };
+		for (int i = 0; produced < outFrames; i = (i + 1) % ARRAYSIZE(chunks)) {
+			const int request = MIN(chunks[i], outFrames - produced);
+			const int result = converter->flow(*input, out + produced * 2, request, volL, volR);
+			produced += result;
+			if (result < request)
+				break;
+		}
+
+		TS_ASSERT_EQUALS(produced, expectedFrames);
+		TS_ASSERT_EQUALS(memcmp(expected, out, outFrames * 2 * sizeof(int16)), 0);
+
+		delete converter;
+		delete input;
+		delete[] out;
+		delete[] expected;
+		delete[] in;
+	}
+
+	void convertTestAllLayouts(int inRate, int outRate) {
+		convertTestTemplate(inRate, outRate, false, false, 256, 256);
+		convertTestTemplate(inRate, outRate, false, false, 200, 37);
+		convertTestTemplate(inRate, outRate, true, false, 256, 256);
+		convertTestTemplate(inRate, outRate, true, false, 0, 129);
+		convertTestTemplate(inRate, outRate, true, true, 256, 256);
+		convertTestTemplate(inRate, outRate, true, true, 91, 255);
+	}
+
+	void sincTestTemplate(int inRate, int outRate, bool stereo, Audio::ResampleQuality quality) {
+		const int numFrames = 4000;
+		const int channels = stereo ? 2 : 1;
+		const int outFrames = numFrames * outRate / inRate;
+		const int16 level = 12345;
+
+		int16 *in = new int16[numFrames * channels];
+		for (int i = 0; i < numFrames * channels; ++i)
+			in[i] = level;
+
+		int16 *out = new int16[outFrames * 2];
+		memset(out, 0, outFrames * 2 * sizeof(int16));
+
+		Audio::AudioStream *input = createNoiseStream(in, numFrames * channels, inRate, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, false, quality);
+
+		const int produced = converter->flow(*input, out, outFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		TS_ASSERT_LESS_THAN_EQUALS(outFrames - 2, produced);
+
+		// Once the filter is filled, a constant input has to come out
+		// unchanged, give or take rounding.
+		for (int i = produced / 2; i < produced * 2; ++i)
+			TS_ASSERT_DELTA(out[i], level, 2);
+
+		delete converter;
+		delete input;
+		delete[] out;
+		delete[] in;
+	}
+
+public:
+	void test_copy_rate_converter() {
+		convertTestAllLayouts(22050, 22050);
+	}
+
+	void test_simple_rate_converter() {
+		convertTestAllLayouts(44100, 22050);
+		convertTestAllLayouts(33075, 11025);
+	}
+
+	void test_linear_rate_converter() {
+		convertTestAllLayouts(11025, 22050);
+		convertTestAllLayouts(22050, 48000);
+		convertTestAllLayouts(44100, 32000);
+	}
+
+	void test_sinc_rate_converter() {
+		sincTestTemplate(11025, 48000, false, Audio::kResampleSincLow);
+		sincTestTemplate(22050, 44100, true, Audio::kResampleSincMedium);
+		sincTestTemplate(44100, 11025, true, Audio::kResampleSincHigh);
+		sincTestTemplate(22222, 48000, false, Audio::kResampleSincHigh);
+	}
+};
@@ -0,0 +1,23 @@
+#ifndef TEST_BENCHMARK_HELPER_H
+#define TEST_BENCHMARK_HELPER_H
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Returns the processor time used so far, in seconds.
+ */
+static double benchClock() {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+/**
+ * Prints the result of a benchmark run which processed count items
+ * (frames, pixels, instructions...) in the given time.
+ */
+static void benchReport(const char *name, double seconds, double count, const char *unit) {
+	printf("\n  %-44s %8.3f ms  %10.2f ns/%s", name, seconds * 1000.0, seconds * 1e9 / count, unit);
+	fflush(stdout);
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "helper.h"
+
+#include <math.h>
+
+class RateConverterBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kOutputRate = 44100,
+		kCallbackFrames = 2048,
+		kSeconds = 20
+	};
+
+	void benchConverter(const char *name, int inRate, bool stereo, Audio::ResampleQuality quality) {
+		const int channels = stereo ? 2 : 1;
+		const int numSamples = inRate * kSeconds * channels;
+
+		int16 *data = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; ++i)
+			data[i] = (int16)(sin(i * 0.01) * 20000);
+
+		Audio::AudioStream *input = Audio::makeRawStream((byte *)data, numSamples * sizeof(int16), inRate,
+		                                                 Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, kOutputRate, stereo, false, quality);
+
+		int16 *out = new int16[kCallbackFrames * 2];
+		int frames = 0, result;
+
+		const double start = benchClock();
+		do {
+			memset(out, 0, kCallbackFrames * 2 * sizeof(int16));
+			result = converter->flow(*input, out, kCallbackFrames, 200, 200);
+			frames += result;
+		} while (result == kCallbackFrames);
+		const double seconds = benchClock() - start;
+
+		benchReport(name, seconds, frames, "frame");
+
+		// Put it in relation to the time budget one mixer callback has
+		printf(" (%5.2f%% of a callback per channel)", seconds / frames * kOutputRate * 100.0);
+
+		delete[] out;
+		delete converter;
+		delete input;
+	}
+
+	void benchAllQualities(int inRate, bool stereo) {
+		static const char *const names[] = { "linear", "sinc low", "sinc medium", "sinc high" };
+
+		for (int q = Audio::kResampleLinear; q <= Audio::kResampleSincHigh; ++q) {
+			char name[64];
+			snprintf(name, sizeof(name), "%5d Hz %s -> 44100 Hz, %s", inRate, stereo ? "stereo" : "mono", names[q]);
+			benchConverter(name, inRate, stereo, (Audio::ResampleQuality)q);
+		}
+	}
+
+public:
+	void test_copy() {
+		benchConverter("44100 Hz stereo -> 44100 Hz, copy", 44100, true, Audio::kResampleLinear);
+	}
+
+	void test_upsample_11025() {
+		benchAllQualities(11025, false);
+	}
+
+	void test_upsample_22050() {
+		benchAllQualities(22050, false);
+		benchAllQualities(22050, true);
+	}
+
+	void test_upsample_32000() {
+		benchAllQualities(32000, true);
+	}
+};
@@ -0,0 +1,112 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+#include "graphics/scaler/hqpattern.h"
+
+#include "helper.h"
+
+class ScalerBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kFrames = 50
+	};
+
+	// Something resembling a game screen: flat areas, hard edges between
+	// them, and dithered and noisy parts where every pixel differs
+	static void fillScreen(uint16 *pixels, uint32 pitch, int width, int height) {
+		uint32 seed = 12345;
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				seed = seed * 1103515245 + 12345;
+				uint16 color = (uint16)(((x / 24) * 0x0841 + (y / 16) * 0x1806) ^ ((x + y) / 40 * 0x2104));
+				if ((x / 64 + y / 48) % 3 == 0)
+					color = (uint16)(seed >> 16);
+				else if ((x / 80 + y / 60) % 4 == 1 && ((x ^ y) & 1))
+					color = ~color;
+				pixels[y * pitch / 2 + x] = color;
+			}
+		}
+	}
+
+	void benchScaler(const char *name, ScalerProc *proc, int factor, int width, int height, HQPatternProc *patternProc, const uint8 *reference, uint8 *out) {
+		const uint32 srcPitch = (width + 4) * 2;
+		const uint32 dstPitch = width * factor * 2;
+
+		uint16 *src = new uint16[(width + 4) * (height + 4)];
+		fillScreen(src, srcPitch, width + 4, height + 4);
+
+		// The scalers read one pixel around the area they scale
+		const uint8 *srcPtr = (const uint8 *)src + 2 * srcPitch + 4;
+
+		HQPatternProc *oldProc = g_hqPatternProc;
+		g_hqPatternProc = patternProc;
+
+		const double start = benchClock();
+		for (int i = 0; i < kFrames; ++i)
+			proc(srcPtr, srcPitch, out, dstPitch, width, height);
+		const double seconds = benchClock() - start;
+
+		g_hqPatternProc = oldProc;
+
+		benchReport(name, seconds / kFrames, width * height, "pixel");
+
+		if (reference)
+			TS_ASSERT_EQUALS(memcmp(reference, out, dstPitch * height * factor), 0);
+
+		delete[] src;
+	}
+
+	void benchAllKernels(const char *scaler, ScalerProc *proc, int factor, int width, int height, int bitFormat) {
+#ifdef USE_HQ_SCALERS
+		InitScalers(bitFormat);
+
+		const uint32 size = width * factor * 2 * height * factor;
+		uint8 *reference = new uint8[size];
+		uint8 *out = new uint8[size];
+		char name[64];
+
+		snprintf(name, sizeof(name), "%s %dx%d %d, C reference", scaler, width, height, bitFormat);
+		benchScaler(name, proc, factor, width, height, 0, 0, reference);
+
+		snprintf(name, sizeof(name), "%s %dx%d %d, C rows", scaler, width, height, bitFormat);
+		benchScaler(name, proc, factor, width, height, HQPatternsC, reference, out);
+
+#ifdef USE_HQ_PATTERN_SSE2
+#ifndef __SSE2__
+		if (__builtin_cpu_supports("sse2"))
+#endif
+		{
+			snprintf(name, sizeof(name), "%s %dx%d %d, SSE2", scaler, width, height, bitFormat);
+			benchScaler(name, proc, factor, width, height, HQPatternsSSE2, reference, out);
+		}
+#endif
+
+#ifdef USE_HQ_PATTERN_AVX2
+		if (__builtin_cpu_supports("avx2")) {
+			snprintf(name, sizeof(name), "%s %dx%d %d, AVX2", scaler, width, height, bitFormat);
+			benchScaler(name, proc, factor, width, height, HQPatternsAVX2, reference, out);
+		}
+#endif
+
+		delete[] out;
+		delete[] reference;
+		DestroyScalers();
+#endif
+	}
+
+public:
+	void test_hq2x() {
+#ifdef USE_HQ_SCALERS
+		benchAllKernels("HQ2x", HQ2x, 2, 320, 200, 565);
+		benchAllKernels("HQ2x", HQ2x, 2, 640, 480, 555);
+#endif
+	}
+
+	void test_hq3x() {
+#ifdef USE_HQ_SCALERS
+		benchAllKernels("HQ3x", HQ3x, 3, 320, 200, 555);
+		benchAllKernels("HQ3x", HQ3x, 3, 640, 480, 565);
+#endif
+	}
+};
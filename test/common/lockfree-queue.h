@@ -0,0 +1,60 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/lockfree-queue.h"
+
+class LockFreeQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty_full() {
+		Common::LockFreeQueue<int, 4> queue;
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.full());
+
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(!queue.empty());
+		TS_ASSERT(!queue.full());
+
+		// One slot always stays unused
+		TS_ASSERT(queue.push(3));
+		TS_ASSERT(queue.full());
+		TS_ASSERT(!queue.push(4));
+	}
+
+	void test_push_pop() {
+		Common::LockFreeQueue<int, 4> queue;
+		int x = 0;
+
+		TS_ASSERT(!queue.pop(x));
+
+		queue.push(42);
+		queue.push(-23);
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 42);
+
+		queue.push(17);
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, -23);
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 17);
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.pop(x));
+	}
+
+	void test_wrap_around() {
+		Common::LockFreeQueue<int, 3> queue;
+		int x = 0;
+
+		for (int i = 0; i < 10; i++) {
+			TS_ASSERT(queue.push(i));
+			TS_ASSERT(queue.push(i + 100));
+			TS_ASSERT(!queue.push(i + 200));
+
+			TS_ASSERT(queue.pop(x));
+			TS_ASSERT_EQUALS(x, i);
+			TS_ASSERT(queue.pop(x));
+			TS_ASSERT_EQUALS(x, i + 100);
+			TS_ASSERT(queue.empty());
+		}
+	}
+};
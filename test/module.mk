@@ -35,8 +35,28 @@ test/runner.cpp: $(TESTS)
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
 
+######################################################################
+# Benchmarks, built on the same CxxTest machinery. They print timings
+# instead of checking results. Use the 'bench' target to run them.
+######################################################################
+
+BENCHMARKS   := $(srcdir)/test/benchmark/*.h
+BENCH_LIBS   := graphics/libgraphics.a $(TEST_LIBS)
+
+# Benchmarks need the C library's clock() and printf()
+BENCH_CFLAGS := $(TEST_CFLAGS) -DFORBIDDEN_SYMBOL_ALLOW_ALL
+
+bench: test/bench_runner
+	./test/bench_runner
+test/bench_runner: test/bench_runner.cpp $(BENCH_LIBS)
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(BENCH_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+test/bench_runner.cpp: $(BENCHMARKS)
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/bench_runner.cpp test/bench_runner
 
-.PHONY: test clean-test
+.PHONY: test bench clean-test
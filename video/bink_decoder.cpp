@@ -26,6 +26,7 @@
 
 #include "audio/decoders/raw.h"
 
+#include "common/debug.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 #include "common/math.h"
@@ -113,6 +114,13 @@ BinkDecoder::BinkDecoder() {
 	}
 
 	_audioStream = 0;
+
+	_decodeAheadFrames = 0;
+	_queueStart = 0;
+	_queueCount = 0;
+	_decodedFrame = -1;
+	_lastDecodeTime = 0;
+	_maxDecodeTime = 0;
 }
 
 void BinkDecoder::startAudio() {
@@ -156,6 +164,11 @@ void BinkDecoder::close() {
 	delete _bink; _bink = 0;
 	_surface.free();
 
+	freeQueue();
+	_decodedFrame = -1;
+	_lastDecodeTime = 0;
+	_maxDecodeTime = 0;
+
 	_audioTrack = 0;
 
 	for (int i = 0; i < kSourceMAX; i++) {
@@ -192,7 +205,34 @@ const Graphics::Surface *BinkDecoder::decodeNextFrame() {
 	if (endOfVideo())
 		return 0;
 
-	VideoFrame &frame = _frames[_curFrame + 1];
+	const Graphics::Surface *surface = &_surface;
+
+	if (_queueCount > 0) {
+		// Hand out the oldest frame decoded ahead of time
+		if (!_queueSurface.pixels)
+			_queueSurface.create(_surface.w, _surface.h, _surface.format);
+
+		SWAP(_queueSurface.pixels, _queue[_queueStart].pixels);
+		_queueStart = (_queueStart + 1) % _queue.size();
+		_queueCount--;
+
+		surface = &_queueSurface;
+	} else
+		decodeFrame();
+
+	_curFrame++;
+	if (_curFrame == 0)
+		_startTime = g_system->getMillis();
+
+	debug(6, "Bink frame %d: decoding took %d ms, %d frames queued", _curFrame, _lastDecodeTime, _queueCount);
+
+	return surface;
+}
+
+void BinkDecoder::decodeFrame() {
+	uint32 startTime = g_system->getMillis();
+
+	VideoFrame &frame = _frames[_decodedFrame + 1];
 
 	if (!_bink->seek(frame.offset))
 		error("Bad bink seek");
@@ -247,11 +287,41 @@ const Graphics::Surface *BinkDecoder::decodeNextFrame() {
 	delete frame.bits;
 	frame.bits = 0;
 
-	_curFrame++;
-	if (_curFrame == 0)
-		_startTime = g_system->getMillis();
+	_decodedFrame++;
+
+	_lastDecodeTime = g_system->getMillis() - startTime;
+	_maxDecodeTime = MAX(_maxDecodeTime, _lastDecodeTime);
+}
+
+void BinkDecoder::setDecodeAhead(uint frameCount) {
+	_decodeAheadFrames = frameCount;
+}
+
+bool BinkDecoder::decodeAhead() {
+	if (!isVideoLoaded() || _queueCount >= _queue.size() || (_decodedFrame + 1) >= (int32)_frames.size())
+		return false;
+
+	Graphics::Surface &entry = _queue[(_queueStart + _queueCount) % _queue.size()];
+	if (!entry.pixels)
+		entry.create(_surface.w, _surface.h, _surface.format);
 
-	return &_surface;
+	decodeFrame();
+
+	SWAP(_surface.pixels, entry.pixels);
+	_queueCount++;
+
+	return true;
+}
+
+void BinkDecoder::freeQueue() {
+	for (uint i = 0; i < _queue.size(); i++)
+		_queue[i].free();
+
+	_queue.clear();
+	_queueSurface.free();
+
+	_queueStart = 0;
+	_queueCount = 0;
 }
 
 void BinkDecoder::audioPacket(AudioTrack &audio) {
@@ -601,6 +671,9 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream, const Graphics:
 
 	_surface.create(width, height, format);
 
+	// The frames decoded ahead of time are allocated as they are needed
+	_queue.resize(_decodeAheadFrames);
+
 	// Give the planes a bit extra space
 	width  = _surface.w  + 32;
 	height = _surface.h + 32;
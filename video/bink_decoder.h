@@ -78,6 +78,31 @@ public:
 
 	// Bink specific
 	bool loadStream(Common::SeekableReadStream *stream, const Graphics::PixelFormat &format);
+
+	/**
+	 * Set the number of frames which may be decoded ahead of time by
+	 * decodeAhead(), starting with the next video loaded. 0, the default,
+	 * disables decoding ahead.
+	 */
+	void setDecodeAhead(uint frameCount);
+
+	/**
+	 * Decode the next frame into the queue of decoded frames, if there
+	 * is room in it. To be called while the player waits for the time of
+	 * the next frame, so that decodeNextFrame() only needs to hand out a
+	 * frame that is ready, which evens out the time expensive frames take.
+	 *
+	 * @return true if a frame was decoded
+	 */
+	bool decodeAhead();
+
+	/** Number of frames decoded ahead of time which are waiting in the queue. */
+	uint getQueuedFrameCount() const { return _queueCount; }
+	/** Time in ms the decoding of the last frame took. */
+	uint32 getLastDecodeTime() const { return _lastDecodeTime; }
+	/** Longest time in ms the decoding of a frame took. */
+	uint32 getMaxDecodeTime() const { return _maxDecodeTime; }
+
 protected:
 	static const int kAudioChannelsMax  = 2;
 	static const int kAudioBlockSizeMax = (kAudioChannelsMax << 11);
@@ -221,6 +246,21 @@ protected:
 
 	Graphics::Surface _surface;
 
+	/**
+	 * Frames decoded ahead of time. Frames are decoded into _surface, and
+	 * their pixels swapped with the ones of the queue entries.
+	 */
+	Common::Array<Graphics::Surface> _queue;
+	uint _decodeAheadFrames; ///< Size of the queue, for the next video loaded.
+	uint _queueStart; ///< Index of the oldest frame in the queue.
+	uint _queueCount; ///< Number of frames in the queue.
+	int32 _decodedFrame; ///< The last frame read from the stream.
+	/** The frame handed out by decodeNextFrame() when decoding ahead. */
+	Graphics::Surface _queueSurface;
+
+	uint32 _lastDecodeTime;
+	uint32 _maxDecodeTime;
+
 	Audio::SoundHandle _audioHandle;
 	Audio::QueuingAudioStream *_audioStream;
 	int32 _audioStartOffset;
@@ -261,6 +301,11 @@ protected:
 	/** Decode a video packet. */
 	virtual void videoPacket(VideoFrame &video);
 
+	/** Read and decode the frame after _decodedFrame into _surface. */
+	void decodeFrame();
+	/** Free the queue of frames decoded ahead of time. */
+	void freeQueue();
+
 	/** Decode a plane. */
 	void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 